@@ -0,0 +1,15 @@
+# Common configuration of the benchmarks.
+#
+# Each benchmark is a QTest executable, run it with e.g. "-csv" or
+# "-o results.xml,xml" to get machine-readable results.
+
+QT  += core testlib concurrent
+QT  -= gui
+
+CONFIG += c++14 console testcase link_pkgconfig
+CONFIG -= app_bundle
+PKGCONFIG += yaml-cpp
+
+TEMPLATE = app
+
+INCLUDEPATH += $$PWD/../src
@@ -0,0 +1,54 @@
+#pragma once
+
+#include "breakpointset.hpp"
+
+#include <QtTest>
+
+#include <vector>
+
+/*! \brief Helpers shared by the benchmarks.
+ */
+namespace BenchmarkData {
+
+	/*! \brief Add the breakpoint count column and one row per synthetic size,
+	 * from 10 to 1M breakpoints.
+	 */
+	inline void sizes() {
+		QTest::addColumn<int>("count");
+
+		QTest::newRow("10") << 10;
+		QTest::newRow("1k") << 1'000;
+		QTest::newRow("10k") << 10'000;
+		QTest::newRow("100k") << 100'000;
+		QTest::newRow("1M") << 1'000'000;
+	}
+
+	/*! \brief Create breakpoints, one every second.
+	 *
+	 * \param count the number of breakpoints.
+	 */
+	inline BreakpointSet makeBreakpoints(int count) {
+		std::vector<qint64> values;
+		values.reserve(count);
+		for(qint64 i = 0 ; i < count ; ++i) {
+			values.push_back(i * 1'000);
+		}
+		return BreakpointSet(std::move(values));
+	}
+
+	/*! \brief Create breakpoints which are not in makeBreakpoints(count).
+	 *
+	 * \param count the number of breakpoints of the existing set.
+	 * \param batch the number of breakpoints to create.
+	 */
+	inline std::vector<qint64> makeNewBreakpoints(int count, int batch) {
+		std::vector<qint64> values;
+		values.reserve(batch);
+		qint64 step = std::max<qint64>(static_cast<qint64>(count) * 1'000 / batch, 1'000);
+		for(qint64 i = 0 ; i < batch ; ++i) {
+			// Half-way between two existing breakpoints
+			values.push_back(i * step + 500);
+		}
+		return values;
+	}
+}
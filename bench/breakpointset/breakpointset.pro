@@ -0,0 +1,6 @@
+include(../bench.pri)
+
+TARGET = bench-breakpointset
+
+SOURCES += breakpointsetbenchmark.cpp ../../src/breakpointset.cpp
+HEADERS += ../../src/breakpointset.hpp
@@ -0,0 +1,110 @@
+#include "../benchmarkdata.hpp"
+
+#include <QtTest>
+
+#include <algorithm>
+
+/*! \brief Benchmarks of the breakpoint lookups done by VideoPlayerManager,
+ * and of the modifications of shared sets.
+ *
+ * Each lookup simulates resetBreakpointsIterators after a seek.
+ */
+class BreakpointSetBenchmark : public QObject {
+
+	Q_OBJECT
+
+private slots:
+	void upperBoundLinear_data();
+	void upperBoundLinear();
+
+	void upperBound_data();
+	void upperBound();
+
+	void upperBoundHintSmallSeek_data();
+	void upperBoundHintSmallSeek();
+
+	void modifySnapshot_data();
+	void modifySnapshot();
+};
+
+using namespace BenchmarkData;
+
+void BreakpointSetBenchmark::upperBoundLinear_data() {
+	sizes();
+}
+
+void BreakpointSetBenchmark::upperBoundLinear() {
+	QFETCH(int, count);
+	BreakpointSet breakpoints = makeBreakpoints(count);
+	qint64 duration = static_cast<qint64>(count) * 1'000, position = 0;
+	volatile std::size_t index = 0;
+
+	// What resetBreakpointsIterators used to do
+	QBENCHMARK {
+		position = (position + 7'919) % duration;
+		index = std::find_if(breakpoints.cbegin(), breakpoints.cend(),
+		                     [position](qint64 value) { return value > position; }) -
+		        breakpoints.cbegin();
+	}
+	Q_UNUSED(index);
+}
+
+void BreakpointSetBenchmark::upperBound_data() {
+	sizes();
+}
+
+void BreakpointSetBenchmark::upperBound() {
+	QFETCH(int, count);
+	BreakpointSet breakpoints = makeBreakpoints(count);
+	qint64 duration = static_cast<qint64>(count) * 1'000, position = 0;
+	volatile std::size_t index = 0;
+
+	QBENCHMARK {
+		position = (position + 7'919) % duration;
+		index = breakpoints.upperBound(position);
+	}
+	Q_UNUSED(index);
+}
+
+void BreakpointSetBenchmark::upperBoundHintSmallSeek_data() {
+	sizes();
+}
+
+void BreakpointSetBenchmark::upperBoundHintSmallSeek() {
+	QFETCH(int, count);
+	BreakpointSet breakpoints = makeBreakpoints(count);
+	qint64 duration = static_cast<qint64>(count) * 1'000, position = 0;
+	std::size_t index = 0;
+
+	// Scrubbing: every seek is close to the previous one
+	QBENCHMARK {
+		position = (position + 1'500) % duration;
+		index = breakpoints.upperBound(position, index);
+	}
+	QVERIFY(index == breakpoints.upperBound(position));
+}
+
+void BreakpointSetBenchmark::modifySnapshot_data() {
+	sizes();
+}
+
+void BreakpointSetBenchmark::modifySnapshot() {
+	QFETCH(int, count);
+	BreakpointSet breakpoints = makeBreakpoints(count);
+	BreakpointSet snapshot;
+	qint64 duration = static_cast<qint64>(count) * 1'000, position = 500;
+
+	// Like a save or the autosave taking a snapshot before each edit
+	QBENCHMARK {
+		snapshot = breakpoints;
+		position = (position + 7'919'000) % duration;
+		if(!breakpoints.insert(position)) {
+			breakpoints.erase(position);
+		}
+	}
+	QVERIFY(snapshot != breakpoints);
+}
+
+QTEST_APPLESS_MAIN(BreakpointSetBenchmark)
+
+#include "breakpointsetbenchmark.moc"
@@ -0,0 +1,68 @@
+#include "../benchmarkdata.hpp"
+
+#include "history.hpp"
+
+#include <QtTest>
+
+/*! \brief Benchmarks of the undo/redo history.
+ */
+class HistoryBenchmark : public QObject {
+
+	Q_OBJECT
+
+private slots:
+	void pushBack_data();
+	void pushBack();
+
+	void goBackAdvance_data();
+	void goBackAdvance();
+};
+
+using namespace BenchmarkData;
+
+void HistoryBenchmark::pushBack_data() {
+	sizes();
+}
+
+void HistoryBenchmark::pushBack() {
+	QFETCH(int, count);
+	ProjectManager project;
+	project.setBreakpoints(makeBreakpoints(count));
+
+	History history(project);
+	history.setCoalescingInterval(0);
+
+	// Each iteration records a new breakpoint, like "Add breakpoint here"
+	qint64 breakpoint = 500;
+	QBENCHMARK {
+		project.addBreakpoint(breakpoint);
+		history.push_back(project.getLastChange());
+		breakpoint += 1'000;
+	}
+}
+
+void HistoryBenchmark::goBackAdvance_data() {
+	sizes();
+}
+
+void HistoryBenchmark::goBackAdvance() {
+	QFETCH(int, count);
+	ProjectManager project;
+	project.setBreakpoints(makeBreakpoints(count));
+
+	History history(project);
+	history.setCoalescingInterval(0);
+
+	// A batch change, like "Add breakpoints regularly" on a tenth of the video
+	project.addBreakpoints(makeNewBreakpoints(count, std::max(count / 10, 1)));
+	history.push_back(project.getLastChange());
+
+	QBENCHMARK {
+		QVERIFY(history.goBack(project));
+		QVERIFY(history.advance(project));
+	}
+}
+
+QTEST_GUILESS_MAIN(HistoryBenchmark)
+
+#include "historybenchmark.moc"
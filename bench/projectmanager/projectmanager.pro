@@ -0,0 +1,6 @@
+include(../bench.pri)
+
+TARGET = bench-projectmanager
+
+SOURCES += projectmanagerbenchmark.cpp ../../src/projectmanager.cpp ../../src/breakpointset.cpp ../../src/breakpointsfile.cpp ../../src/timeline.cpp
+HEADERS += ../../src/projectmanager.hpp ../../src/breakpointset.hpp ../../src/breakpointsfile.hpp ../../src/timeline.hpp
@@ -0,0 +1,201 @@
+#include "../benchmarkdata.hpp"
+
+#include "projectmanager.hpp"
+
+#include <QtTest>
+#include <QTemporaryDir>
+
+/*! \brief Benchmarks of the project loading, saving and editing.
+ */
+class ProjectManagerBenchmark : public QObject {
+
+	Q_OBJECT
+
+private slots:
+	void initTestCase();
+
+	void loadYaml_data();
+	void loadYaml();
+
+	void loadBinary_data();
+	void loadBinary();
+
+	void saveYaml_data();
+	void saveYaml();
+
+	void saveBinary_data();
+	void saveBinary();
+
+	void addRemoveBreakpoints_data();
+	void addRemoveBreakpoints();
+
+	void replaceBreakpoint_data();
+	void replaceBreakpoint();
+
+	void copyProject_data();
+	void copyProject();
+
+	void moveProject_data();
+	void moveProject();
+
+private:
+	/*! \brief Create a project with count breakpoints in the temporary directory.
+	 *
+	 * \param count the number of breakpoints.
+	 * \param format how the breakpoints are stored.
+	 * \return the project file path.
+	 */
+	std::string createProject(int count, ProjectManager::BreakpointsFormat format);
+
+	QTemporaryDir directory;
+};
+
+using namespace BenchmarkData;
+
+void ProjectManagerBenchmark::initTestCase() {
+	QVERIFY(directory.isValid());
+}
+
+std::string ProjectManagerBenchmark::createProject(int count,
+                                                   ProjectManager::BreakpointsFormat format) {
+	QString name = QString("project-%1-%2.eo")
+	                 .arg(count)
+	                 .arg(format == ProjectManager::BreakpointsFormat::Yaml ? "yaml" : "binary");
+	std::string projectFile = directory.filePath(name).toStdString();
+
+	ProjectManager project(projectFile, "video.avi");
+	project.setBreakpoints(makeBreakpoints(count));
+	project.setBreakpointsFormat(format);
+	project.saveProject();
+	project.waitForSaved();
+
+	return projectFile;
+}
+
+void ProjectManagerBenchmark::loadYaml_data() {
+	sizes();
+}
+
+void ProjectManagerBenchmark::loadYaml() {
+	QFETCH(int, count);
+	std::string projectFile = createProject(count, ProjectManager::BreakpointsFormat::Yaml);
+
+	QBENCHMARK {
+		ProjectManager project(projectFile);
+		QCOMPARE(project.getBreakpoints().size(), static_cast<std::size_t>(count));
+	}
+}
+
+void ProjectManagerBenchmark::loadBinary_data() {
+	sizes();
+}
+
+void ProjectManagerBenchmark::loadBinary() {
+	QFETCH(int, count);
+	std::string projectFile = createProject(count, ProjectManager::BreakpointsFormat::Binary);
+
+	QBENCHMARK {
+		ProjectManager project(projectFile);
+		QCOMPARE(project.getBreakpoints().size(), static_cast<std::size_t>(count));
+	}
+}
+
+void ProjectManagerBenchmark::saveYaml_data() {
+	sizes();
+}
+
+void ProjectManagerBenchmark::saveYaml() {
+	QFETCH(int, count);
+	ProjectManager project(createProject(count, ProjectManager::BreakpointsFormat::Yaml));
+
+	QBENCHMARK {
+		project.saveProject();
+		project.waitForSaved();
+	}
+}
+
+void ProjectManagerBenchmark::saveBinary_data() {
+	sizes();
+}
+
+void ProjectManagerBenchmark::saveBinary() {
+	QFETCH(int, count);
+	ProjectManager project(createProject(count, ProjectManager::BreakpointsFormat::Binary));
+
+	QBENCHMARK {
+		project.saveProject();
+		project.waitForSaved();
+	}
+}
+
+void ProjectManagerBenchmark::addRemoveBreakpoints_data() {
+	sizes();
+}
+
+void ProjectManagerBenchmark::addRemoveBreakpoints() {
+	QFETCH(int, count);
+	ProjectManager project;
+	project.setBreakpoints(makeBreakpoints(count));
+	// Like "Add breakpoints regularly" on a tenth of the video
+	std::vector<qint64> batch = makeNewBreakpoints(count, std::max(count / 10, 1));
+
+	QBENCHMARK {
+		project.addBreakpoints(batch);
+		project.removeBreakpoints(batch);
+	}
+	QCOMPARE(project.getBreakpoints().size(), static_cast<std::size_t>(count));
+}
+
+void ProjectManagerBenchmark::replaceBreakpoint_data() {
+	sizes();
+}
+
+void ProjectManagerBenchmark::replaceBreakpoint() {
+	QFETCH(int, count);
+	ProjectManager project;
+	project.setBreakpoints(makeBreakpoints(count));
+	// Move the first breakpoint to the end and back, the worst case
+	qint64 first = 0, last = static_cast<qint64>(count) * 1'000;
+
+	QBENCHMARK {
+		project.replaceBreakpoint(first, last);
+		project.replaceBreakpoint(last, first);
+	}
+	QCOMPARE(project.getBreakpoints().size(), static_cast<std::size_t>(count));
+}
+
+void ProjectManagerBenchmark::copyProject_data() {
+	sizes();
+}
+
+void ProjectManagerBenchmark::copyProject() {
+	QFETCH(int, count);
+	ProjectManager project;
+	project.setBreakpoints(makeBreakpoints(count));
+
+	// The breakpoints are shared until one of the copies is modified
+	QBENCHMARK {
+		ProjectManager copy(project);
+		QCOMPARE(copy.getBreakpoints().size(), static_cast<std::size_t>(count));
+	}
+}
+
+void ProjectManagerBenchmark::moveProject_data() {
+	sizes();
+}
+
+void ProjectManagerBenchmark::moveProject() {
+	QFETCH(int, count);
+	ProjectManager project, other;
+	project.setBreakpoints(makeBreakpoints(count));
+
+	QBENCHMARK {
+		other = std::move(project);
+		project = std::move(other);
+	}
+	QCOMPARE(project.getBreakpoints().size(), static_cast<std::size_t>(count));
+}
+
+QTEST_GUILESS_MAIN(ProjectManagerBenchmark)
+
+#include "projectmanagerbenchmark.moc"
@@ -68,17 +68,8 @@ void AddBreakpointRegularlyDialog::cancel() {
 void AddBreakpointRegularlyDialog::validate() {
 	MainWindow& mwParent = dynamic_cast<MainWindow&>(parent);
 
-	qint64 fromTimeMSecs = getMSecs(fromTime), toTimeMSecs = getMSecs(toTime),
-	       everyTimeMSecs = getMSecs(everyTime);
-
-	std::vector<qint64> breakpoints{};
-
-	for(qint64 breakpointPos = fromTimeMSecs; breakpointPos <= toTimeMSecs;
-	    breakpointPos += everyTimeMSecs) {
-		breakpoints.push_back(breakpointPos);
-	}
-
-	mwParent.addProjectBreakpoints(breakpoints);
+	mwParent.addProjectBreakpoints(
+	  regularBreakpoints(getMSecs(fromTime), getMSecs(toTime), getMSecs(everyTime)));
 
 	done(0);
 }
@@ -0,0 +1,195 @@
+#include "autosave.hpp"
+
+#include <QSaveFile>
+
+#include <algorithm>
+#include <map>
+
+namespace {
+
+// For each breakpoint, its first and last operations
+using Operations = std::map<qint64, std::pair<char, char>>;
+
+void replay(QString const& fileName, Operations& operations) {
+	QFile file(fileName);
+	if(!file.open(QIODevice::ReadOnly)) {
+		return;
+	}
+
+	while(!file.atEnd()) {
+		QByteArray line = file.readLine().trimmed();
+		if(line.size() < 2 || (line[0] != '+' && line[0] != '-')) {
+			continue;
+		}
+
+		bool valid;
+		qint64 breakpoint = line.mid(1).toLongLong(&valid);
+		if(!valid) {
+			continue;
+		}
+
+		auto inserted = operations.emplace(breakpoint, std::make_pair(line[0], line[0]));
+		inserted.first->second.second = line[0];
+	}
+}
+
+QByteArray changeLines(BreakpointsChange const& change) {
+	QByteArray lines;
+	for(qint64 breakpoint : change.removed) {
+		lines += '-' + QByteArray::number(breakpoint) + '\n';
+	}
+	for(qint64 breakpoint : change.inserted) {
+		lines += '+' + QByteArray::number(breakpoint) + '\n';
+	}
+	return lines;
+}
+
+} // namespace
+
+Autosave::Autosave(ProjectManager& project, QObject* parent)
+      : QObject(parent)
+      , project(project)
+      , journal()
+      , compactionTimer() {
+	compactionTimer.setInterval(60'000);
+
+	connect(&project, SIGNAL(breakpointsChanged()), this, SLOT(journalChange()));
+	connect(&project, SIGNAL(saveStarted()), this, SLOT(saveStarted()));
+	connect(&project, SIGNAL(projectSaved(bool, QString const&)), this, SLOT(saveFinished(bool)));
+	connect(&compactionTimer, SIGNAL(timeout()), this, SLOT(compact()));
+}
+
+QString Autosave::journalFile(std::string const& projectFile) {
+	return QString::fromStdString(projectFile) + ".journal";
+}
+
+QString Autosave::snapshotFile(std::string const& projectFile) {
+	return QString::fromStdString(projectFile) + ".autosave";
+}
+
+bool Autosave::hasJournal(std::string const& projectFile) {
+	QFile file(journalFile(projectFile));
+	QFile snapshot(snapshotFile(projectFile));
+	return (file.exists() && file.size() > 0) || (snapshot.exists() && snapshot.size() > 0);
+}
+
+BreakpointsChange Autosave::readJournal(std::string const& projectFile) {
+	// If a breakpoint was first inserted, it was not in the saved project, and
+	// its last operation tells if it is still in the project.
+	Operations operations;
+	replay(snapshotFile(projectFile), operations);
+	replay(journalFile(projectFile), operations);
+
+	BreakpointsChange change;
+	for(auto const& operation : operations) {
+		if(operation.second.first == '+' && operation.second.second == '+') {
+			change.inserted.push_back(operation.first);
+		} else if(operation.second.first == '-' && operation.second.second == '-') {
+			change.removed.push_back(operation.first);
+		}
+	}
+	return change;
+}
+
+void Autosave::start() {
+	stop(false);
+
+	QFile::remove(snapshotFile(project.getProjectFile()));
+	journal.setFileName(journalFile(project.getProjectFile()));
+	if(journal.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+		compactionTimer.start();
+	}
+}
+
+void Autosave::stop(bool removeJournal) {
+	compactionTimer.stop();
+	savingOffsets.clear();
+
+	if(journal.isOpen()) {
+		journal.close();
+		if(removeJournal) {
+			journal.remove();
+			QFile::remove(snapshotFile(project.getProjectFile()));
+		}
+	}
+}
+
+void Autosave::setCompactionInterval(int msecs) {
+	compactionTimer.setInterval(msecs);
+}
+
+void Autosave::journalChange() {
+	if(!journal.isOpen()) {
+		return;
+	}
+
+	QByteArray lines = changeLines(project.getLastChange());
+	if(journal.write(lines) != lines.size() || !journal.flush()) {
+		// A partially written journal could not be replayed safely
+		QString error = journal.errorString();
+		stop(true);
+		emit journalFailed("Could not write the autosave journal: " + error);
+	}
+}
+
+void Autosave::compact() {
+	if(!journal.isOpen() || journal.size() == 0 || !savingOffsets.empty()) {
+		return;
+	}
+
+	QByteArray lines = changeLines(readJournal(project.getProjectFile()));
+	QSaveFile snapshot(snapshotFile(project.getProjectFile()));
+	if(!snapshot.open(QIODevice::WriteOnly) || snapshot.write(lines) != lines.size() ||
+	   !snapshot.commit()) {
+		return;
+	}
+
+	// Everything in the journal is now in the snapshot
+	journal.close();
+	journal.open(QIODevice::WriteOnly | QIODevice::Truncate);
+}
+
+void Autosave::saveStarted() {
+	if(journal.isOpen()) {
+		savingOffsets.push_back(journal.size());
+	}
+}
+
+void Autosave::saveFinished(bool success) {
+	if(savingOffsets.empty()) {
+		return;
+	}
+
+	qint64 offset = savingOffsets.front();
+	savingOffsets.pop_front();
+
+	if(!success || !journal.isOpen()) {
+		return;
+	}
+
+	// The snapshot was written before the save started, as no compaction
+	// runs during a save, so the project file now holds it
+	QFile::remove(snapshotFile(project.getProjectFile()));
+
+	// Keep only the changes made after the save started
+	QFile readJournal(journal.fileName());
+	QByteArray remaining;
+	if(readJournal.open(QIODevice::ReadOnly) && readJournal.seek(offset)) {
+		remaining = readJournal.readAll();
+	}
+	readJournal.close();
+
+	QSaveFile compacted(journal.fileName());
+	if(!compacted.open(QIODevice::WriteOnly) || compacted.write(remaining) != remaining.size() ||
+	   !compacted.commit()) {
+		return;
+	}
+
+	// The journal file was replaced, so it must be re-opened
+	journal.close();
+	journal.open(QIODevice::WriteOnly | QIODevice::Append);
+
+	for(qint64& savingOffset : savingOffsets) {
+		savingOffset = std::max<qint64>(savingOffset - offset, 0);
+	}
+}
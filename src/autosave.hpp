@@ -0,0 +1,124 @@
+#pragma once
+
+#include "projectmanager.hpp"
+
+#include <QObject>
+
+#include <QFile>
+#include <QTimer>
+
+#include <deque>
+
+/*! \brief Class used to keep the project's modifications safe between saves.
+ *
+ * Each change of the breakpoints is appended to a journal next to the
+ * project file, which is cheap compared to writing the whole project. The
+ * journal is regularly compacted into an autosave snapshot, which holds the
+ * net modifications since the project was last saved; the project file
+ * itself is only written when the user saves. Both are removed when the
+ * project is closed properly. If they are found when opening a project, it
+ * means slideo crashed and they can be replayed.
+ *
+ * The journal and the snapshot contain one line per inserted ("+<msecs>") or
+ * removed ("-<msecs>") breakpoint.
+ */
+class Autosave : public QObject {
+
+	Q_OBJECT
+
+public:
+	/*! \brief Autosave constructor.
+	 *
+	 * \param project the project to journal.
+	 * \param parent the parent object.
+	 */
+	explicit Autosave(ProjectManager& project, QObject* parent = nullptr);
+
+	/*! \brief Get the path of the journal of a project.
+	 *
+	 * \param projectFile the project file path.
+	 * \return the journal path.
+	 */
+	static QString journalFile(std::string const& projectFile);
+
+	/*! \brief Get the path of the autosave snapshot of a project.
+	 *
+	 * \param projectFile the project file path.
+	 * \return the snapshot path.
+	 */
+	static QString snapshotFile(std::string const& projectFile);
+
+	/*! \brief Check if a project has modifications left in its journal.
+	 *
+	 * \param projectFile the project file path.
+	 * \return true if the journal or the snapshot exists and is not empty.
+	 */
+	static bool hasJournal(std::string const& projectFile);
+
+	/*! \brief Read the modifications left in the journal of a project.
+	 *
+	 * The snapshot is replayed first, then the journal. Invalid lines (e.g. a
+	 * line truncated by a crash) are ignored.
+	 *
+	 * \param projectFile the project file path.
+	 * \return the modifications to apply to the saved project.
+	 */
+	static BreakpointsChange readJournal(std::string const& projectFile);
+
+	/*! \brief Start journaling the current project.
+	 *
+	 * The previous journal and snapshot of the project, if any, are
+	 * discarded.
+	 */
+	void start();
+
+	/*! \brief Stop journaling.
+	 *
+	 * \param removeJournal true if the project was closed properly and the
+	 *        journal and the snapshot are not needed anymore.
+	 */
+	void stop(bool removeJournal);
+
+	/*! \brief Set the interval between two compactions of the journal.
+	 *
+	 * \param msecs the interval in msecs.
+	 */
+	void setCompactionInterval(int msecs);
+
+signals:
+	/*! \brief Signal emitted when a change could not be journaled.
+	 *
+	 * Journaling is stopped and the journal and the snapshot are removed.
+	 *
+	 * \param error the error message.
+	 */
+	void journalFailed(QString const& error) const;
+
+protected slots:
+	/*! \brief Append the last change of the project to the journal.
+	 */
+	void journalChange();
+
+	/*! \brief Move the journal into the snapshot if it is not empty.
+	 */
+	void compact();
+
+	/*! \brief Remember which part of the journal is being saved.
+	 */
+	void saveStarted();
+
+	/*! \brief Remove the snapshot and the saved part of the journal.
+	 *
+	 * \param success true if the project was written.
+	 */
+	void saveFinished(bool success);
+
+protected:
+	ProjectManager& project;
+
+	QFile journal;
+	QTimer compactionTimer;
+
+	// Size of the journal when each running save started
+	std::deque<qint64> savingOffsets;
+};
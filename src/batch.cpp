@@ -0,0 +1,161 @@
+#include "batch.hpp"
+
+#include "projectmanager.hpp"
+#include "timelinedecoder.hpp"
+
+#include <QCommandLineParser>
+#include <QTextStream>
+#include <QThreadPool>
+
+#include <QtConcurrent>
+
+#include <cstring>
+#include <exception>
+
+namespace {
+	// Function object so QtConcurrent can deduce the result type
+	struct ProjectJob {
+		// An empty string on success, the error otherwise
+		using result_type = QString;
+
+		QString command;
+		qint64 from = 0;
+		// -1 for the end of the timeline
+		qint64 to = -1;
+		qint64 every = 1'000;
+		ProjectManager::BreakpointsFormat format = ProjectManager::BreakpointsFormat::Yaml;
+
+		result_type operator()(QString const& projectFile) const {
+			try {
+				if(command == "convert") {
+					ProjectManager::convertProject(projectFile.toStdString(), format);
+					return QString();
+				}
+
+				ProjectManager project(projectFile.toStdString());
+				TimelineDecoder decoder(project.getTimeline());
+				Timeline timeline = decoder.getTimeline();
+
+				// The decoder only opens the clips it needs, check that every
+				// one can be decoded
+				for(std::size_t i = 0 ; i < timeline.size() ; ++i) {
+					if(!decoder.decodeFrameAt(timeline.at(i).offset)) {
+						return "could not decode " + timeline.at(i).file;
+					}
+				}
+
+				if(command == "validate") {
+					BreakpointSet const& breakpoints = project.getBreakpoints();
+					qint64 last = breakpoints.empty() ? 0 : breakpoints.at(breakpoints.size() - 1);
+					if(last > timeline.getDuration()) {
+						return "breakpoint " + QString::number(last) + " is after the end of the video";
+					}
+				} else if(command == "regenerate") {
+					qint64 end = (to >= 0) ? to : timeline.getDuration();
+					project.setBreakpoints(BreakpointSet(regularBreakpoints(from, end, every)));
+					project.saveProject();
+					project.waitForSaved();
+					if(!project.isSaved()) {
+						return "could not save the project";
+					}
+				}
+			} catch(std::exception const& e) {
+				return QString::fromLocal8Bit(e.what());
+			}
+			return QString();
+		}
+	};
+}
+
+bool Batch::isRequested(int argc, char* argv[]) {
+	for(int i = 1 ; i < argc ; ++i) {
+		if(std::strcmp(argv[i], "--batch") == 0) {
+			return true;
+		}
+	}
+	return false;
+}
+
+int Batch::run(QCoreApplication& app) {
+	QTextStream out(stdout), err(stderr);
+
+	QCommandLineParser parser;
+	parser.setApplicationDescription("Process Slideo projects without the user interface.");
+	parser.addHelpOption();
+
+	QCommandLineOption batchOption("batch", "Run without the user interface.");
+	QCommandLineOption fromOption("from", "regenerate: position of the first breakpoint.", "msecs", "0");
+	QCommandLineOption toOption("to", "regenerate: position after which there is no breakpoint "
+	                                  "(default: the end of the video).", "msecs");
+	QCommandLineOption everyOption("every", "regenerate: interval between the breakpoints.", "msecs",
+	                               "1000");
+	QCommandLineOption formatOption("format", "convert: format of the breakpoints, yaml or binary.",
+	                                "format", "yaml");
+	QCommandLineOption jobsOption(QStringList{"j", "jobs"},
+	                              "Number of projects processed in parallel (default: one per core).",
+	                              "count");
+	parser.addOptions({batchOption, fromOption, toOption, everyOption, formatOption, jobsOption});
+	parser.addPositionalArgument("command", "validate, regenerate or convert.");
+	parser.addPositionalArgument("projects", "The project files.", "<project>...");
+	parser.process(app);
+
+	QStringList projects = parser.positionalArguments();
+	if(projects.size() < 2) {
+		parser.showHelp(1);
+	}
+
+	ProjectJob job;
+	job.command = projects.takeFirst();
+	if(job.command != "validate" && job.command != "regenerate" && job.command != "convert") {
+		err << "Unknown command: " << job.command << '\n';
+		return 1;
+	}
+
+	bool valid = true;
+	auto msecs = [&parser, &valid](QCommandLineOption const& option, qint64 fallback) {
+		if(!parser.isSet(option)) {
+			return fallback;
+		}
+		bool ok;
+		qint64 value = parser.value(option).toLongLong(&ok);
+		valid = valid && ok && value >= 0;
+		return value;
+	};
+	job.from = msecs(fromOption, job.from);
+	job.to = msecs(toOption, job.to);
+	job.every = msecs(everyOption, job.every);
+	if(!valid || job.every == 0) {
+		err << "Invalid position or interval\n";
+		return 1;
+	}
+
+	QString format = parser.value(formatOption);
+	if(format == "binary") {
+		job.format = ProjectManager::BreakpointsFormat::Binary;
+	} else if(format != "yaml") {
+		err << "Unknown format: " << format << '\n';
+		return 1;
+	}
+
+	if(parser.isSet(jobsOption)) {
+		int jobs = parser.value(jobsOption).toInt();
+		if(jobs <= 0) {
+			err << "Invalid number of jobs\n";
+			return 1;
+		}
+		QThreadPool::globalInstance()->setMaxThreadCount(jobs);
+	}
+
+	QList<QString> results = QtConcurrent::blockingMapped<QList<QString>>(projects, job);
+
+	int failures = 0;
+	for(int i = 0 ; i < projects.size() ; ++i) {
+		if(results[i].isEmpty()) {
+			out << projects[i] << ": ok\n";
+		} else {
+			err << projects[i] << ": " << results[i] << '\n';
+			++failures;
+		}
+	}
+	return (failures > 0) ? 1 : 0;
+}
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <QCoreApplication>
+
+/*! \brief Processing of projects from the command line, without the user
+ * interface.
+ *
+ * Usage: slideo --batch <command> [options] <project>...
+ *
+ * Commands:
+ *   - validate : check that the projects, their breakpoints and their video
+ *     clips can be read
+ *   - regenerate : replace the breakpoints by regular ones (--from, --to,
+ *     --every)
+ *   - convert : store the breakpoints in another format (--format)
+ *
+ * The projects are processed in parallel, and no widget is created so it
+ * runs without a display.
+ */
+namespace Batch {
+
+	/*! \brief Returns true if the command line asks for the batch mode.
+	 *
+	 * Checked before the application is created, so a QCoreApplication is
+	 * created instead of a QApplication.
+	 *
+	 * \param argc the number of arguments.
+	 * \param argv the arguments.
+	 */
+	bool isRequested(int argc, char* argv[]);
+
+	/*! \brief Process the projects given on the command line.
+	 *
+	 * The result of each project is printed, the errors on the error output.
+	 *
+	 * \param app the application, holding the arguments.
+	 * \return the exit code, 0 if every project was processed.
+	 */
+	int run(QCoreApplication& app);
+}
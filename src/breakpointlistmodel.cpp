@@ -0,0 +1,183 @@
+#include "breakpointlistmodel.hpp"
+
+#include <QTime>
+
+#include <algorithm>
+
+constexpr int BreakpointListModel::fetchedRows;
+
+BreakpointListModel::BreakpointListModel(ProjectManager& project, QObject* parent)
+      : QAbstractListModel(parent)
+      , project(project)
+      , rows(std::min<int>(project.getBreakpoints().size(), fetchedRows)) {
+	// Thousands of thumbnails might be generated, do not repaint for each one
+	thumbnailsTimer.setSingleShot(true);
+	thumbnailsTimer.setInterval(100);
+	connect(&thumbnailsTimer, SIGNAL(timeout()), this, SLOT(updateThumbnails()));
+}
+
+void BreakpointListModel::connectProject() {
+	// A project might be activated several times
+	connect(&project, SIGNAL(breakpointsRemoved(int, int)), this,
+	        SLOT(removeBreakpointRows(int, int)), Qt::UniqueConnection);
+	connect(&project, SIGNAL(breakpointsInserted(int, int)), this,
+	        SLOT(insertBreakpointRows(int, int)), Qt::UniqueConnection);
+	connect(&project, SIGNAL(breakpointMoved(int, int)), this, SLOT(moveBreakpointRow(int, int)),
+	        Qt::UniqueConnection);
+	connect(&project, SIGNAL(breakpointsChanged()), this, SLOT(checkRowCount()),
+	        Qt::UniqueConnection);
+}
+
+void BreakpointListModel::setThumbnailProvider(ThumbnailProvider* thumbnails) {
+	if(this->thumbnails) {
+		disconnect(this->thumbnails, SIGNAL(thumbnailReady(qint64)), this,
+		           SLOT(thumbnailReady(qint64)));
+	}
+
+	this->thumbnails = thumbnails;
+	if(thumbnails) {
+		connect(thumbnails, SIGNAL(thumbnailReady(qint64)), this, SLOT(thumbnailReady(qint64)));
+		placeholder = QImage(thumbnails->getThumbnailSize(), QImage::Format_RGB32);
+		placeholder.fill(Qt::darkGray);
+	}
+}
+
+int BreakpointListModel::rowCount(QModelIndex const& parent) const {
+	return parent.isValid() ? 0 : rows;
+}
+
+bool BreakpointListModel::canFetchMore(QModelIndex const& parent) const {
+	return !parent.isValid() && rows < static_cast<int>(project.getBreakpoints().size());
+}
+
+void BreakpointListModel::fetchMore(QModelIndex const& parent) {
+	int available = static_cast<int>(project.getBreakpoints().size()) - rows;
+	if(parent.isValid() || available <= 0) {
+		return;
+	}
+
+	int count = std::min(available, fetchedRows);
+	beginInsertRows(QModelIndex(), rows, rows + count - 1);
+	rows += count;
+	endInsertRows();
+}
+
+QVariant BreakpointListModel::data(QModelIndex const& index, int role) const {
+	if(!index.isValid() || index.row() >= rows) {
+		return QVariant();
+	}
+
+	if(role == Qt::DisplayRole || role == Qt::EditRole) {
+		return format(project.getBreakpoints().at(index.row()));
+	} else if(role == Qt::DecorationRole && thumbnails) {
+		QImage thumbnail = thumbnails->thumbnail(project.getBreakpoints().at(index.row()));
+		return thumbnail.isNull() ? placeholder : thumbnail;
+	}
+
+	return QVariant();
+}
+
+bool BreakpointListModel::setData(QModelIndex const& index, QVariant const& value, int role) {
+	if(!index.isValid() || role != Qt::EditRole || index.row() >= rows) {
+		return false;
+	}
+
+	QTime time = QTime::fromString(value.toString(), "HH:mm:ss.zzz");
+	if(!time.isValid()) {
+		return false;
+	}
+
+	// The views are notified through the project's signals
+	project.replaceBreakpoint(project.getBreakpoints().at(index.row()),
+	                          QTime(0, 0, 0, 0).msecsTo(time));
+	return true;
+}
+
+Qt::ItemFlags BreakpointListModel::flags(QModelIndex const& index) const {
+	return QAbstractListModel::flags(index) | Qt::ItemIsEditable;
+}
+
+QString BreakpointListModel::format(qint64 breakpoint) {
+	return QTime(0, 0, 0, 0).addMSecs(breakpoint).toString("HH:mm:ss.zzz");
+}
+
+// The known rows stay the first breakpoints of the project: rows inserted
+// right after them are known, rows beyond them are left to fetchMore
+
+void BreakpointListModel::removeBreakpointRows(int first, int last) {
+	last = std::min(last, rows - 1);
+	if(first > last) {
+		return;
+	}
+
+	beginRemoveRows(QModelIndex(), first, last);
+	rows -= last - first + 1;
+	endRemoveRows();
+}
+
+void BreakpointListModel::insertBreakpointRows(int first, int last) {
+	if(first > rows) {
+		return;
+	}
+
+	beginInsertRows(QModelIndex(), first, last);
+	rows += last - first + 1;
+	endInsertRows();
+}
+
+void BreakpointListModel::moveBreakpointRow(int from, int to) {
+	if(from >= rows) {
+		if(to < rows) {
+			insertBreakpointRows(to, to);
+		}
+	} else if(to >= rows) {
+		removeBreakpointRows(from, from);
+	} else if(from == to) {
+		QModelIndex modified = index(to);
+		emit dataChanged(modified, modified);
+	} else {
+		// The destination is the row before which the breakpoint is moved
+		beginMoveRows(QModelIndex(), from, from, QModelIndex(), (to > from) ? to + 1 : to);
+		endMoveRows();
+		QModelIndex modified = index(to);
+		emit dataChanged(modified, modified);
+	}
+}
+
+void BreakpointListModel::checkRowCount() {
+	if(rows > static_cast<int>(project.getBreakpoints().size())) {
+		// Should not happen
+		resetBreakpoints();
+	}
+}
+
+void BreakpointListModel::resetBreakpoints() {
+	beginResetModel();
+	rows = std::min<int>(project.getBreakpoints().size(), fetchedRows);
+	endResetModel();
+}
+
+void BreakpointListModel::thumbnailReady(qint64 position) {
+	readyThumbnails.push_back(position);
+	if(!thumbnailsTimer.isActive()) {
+		thumbnailsTimer.start();
+	}
+}
+
+void BreakpointListModel::updateThumbnails() {
+	BreakpointSet const& breakpoints = project.getBreakpoints();
+
+	int first = rows, last = -1;
+	for(qint64 position : readyThumbnails) {
+		std::size_t row = breakpoints.lowerBound(position);
+		if(row < breakpoints.size() && breakpoints.at(row) == position) {
+			first = std::min(first, static_cast<int>(row));
+			last = std::max(last, static_cast<int>(row));
+		}
+	}
+	readyThumbnails.clear();
+
+	if(first <= last && last < rows) {
+		emit dataChanged(index(first), index(last), {Qt::DecorationRole});
+	}
+}
@@ -0,0 +1,150 @@
+#pragma once
+
+#include "projectmanager.hpp"
+#include "thumbnailprovider.hpp"
+
+#include <QAbstractListModel>
+
+#include <QImage>
+#include <QTimer>
+
+#include <vector>
+
+/*! \brief Model of the breakpoints dock.
+ *
+ * Backed directly by the project's breakpoints, which are only formatted when
+ * displayed. Changes of the project's breakpoints are forwarded to the views
+ * as inserted/removed/moved rows so they do not need to reset.
+ *
+ * The rows are populated progressively through fetchMore: the views only know
+ * about the first breakpoints until they are scrolled further. Changes beyond
+ * the known rows are not forwarded.
+ */
+class BreakpointListModel : public QAbstractListModel {
+
+	Q_OBJECT
+
+public:
+	/*! \brief BreakpointListModel constructor.
+	 *
+	 * \param project the project whose breakpoints are shown.
+	 * \param parent the parent object.
+	 */
+	explicit BreakpointListModel(ProjectManager& project, QObject* parent = nullptr);
+
+	/*! \brief Connect the project's change notifications to the model.
+	 */
+	void connectProject();
+
+	/*! \brief Show the thumbnails of a provider as decoration.
+	 *
+	 * \param thumbnails the provider, nullptr to show no thumbnail.
+	 */
+	void setThumbnailProvider(ThumbnailProvider* thumbnails);
+
+	/*! \brief Get the number of breakpoints.
+	 */
+	int rowCount(QModelIndex const& parent = QModelIndex()) const override;
+
+	/*! \brief Returns true if some breakpoints are not known by the views yet.
+	 */
+	bool canFetchMore(QModelIndex const& parent) const override;
+
+	/*! \brief Make the next breakpoints known to the views.
+	 */
+	void fetchMore(QModelIndex const& parent) override;
+
+	/*! \brief Get a breakpoint formatted as "HH:mm:ss.zzz", or its thumbnail.
+	 *
+	 * Thumbnails are only requested for the rows the views show, and replaced
+	 * by a placeholder until they are available.
+	 *
+	 * \param index the index of the breakpoint.
+	 * \param role only Qt::DisplayRole, Qt::EditRole and Qt::DecorationRole
+	 *        are supported.
+	 */
+	QVariant data(QModelIndex const& index, int role = Qt::DisplayRole) const override;
+
+	/*! \brief Replace a breakpoint when the user edits it.
+	 *
+	 * \param index the index of the breakpoint.
+	 * \param value the new position, formatted as "HH:mm:ss.zzz".
+	 * \param role must be Qt::EditRole.
+	 * \return true if the breakpoint was replaced.
+	 */
+	bool setData(QModelIndex const& index, QVariant const& value,
+	             int role = Qt::EditRole) override;
+
+	/*! \brief Breakpoints are editable.
+	 */
+	Qt::ItemFlags flags(QModelIndex const& index) const override;
+
+	/*! \brief Format a breakpoint as "HH:mm:ss.zzz".
+	 *
+	 * \param breakpoint the breakpoint in msecs.
+	 */
+	static QString format(qint64 breakpoint);
+
+public slots:
+	/*! \brief Forward removed breakpoints to the views.
+	 *
+	 * \param first the row of the first removed breakpoint.
+	 * \param last the row of the last removed breakpoint.
+	 */
+	void removeBreakpointRows(int first, int last);
+
+	/*! \brief Forward inserted breakpoints to the views.
+	 *
+	 * \param first the row of the first inserted breakpoint.
+	 * \param last the row of the last inserted breakpoint.
+	 */
+	void insertBreakpointRows(int first, int last);
+
+	/*! \brief Forward a replaced breakpoint to the views.
+	 *
+	 * \param from the row of the breakpoint before the change.
+	 * \param to the row of the breakpoint after the change.
+	 */
+	void moveBreakpointRow(int from, int to);
+
+	/*! \brief Check that the views are in sync with the project.
+	 *
+	 * Called at the end of each change of the project's breakpoints.
+	 */
+	void checkRowCount();
+
+	/*! \brief Reset the whole model.
+	 *
+	 * Called when a project is loaded. Only the first breakpoints are known to
+	 * the views after a reset.
+	 */
+	void resetBreakpoints();
+
+	/*! \brief Remember a thumbnail which became available.
+	 *
+	 * The views are notified in batches, see updateThumbnails.
+	 *
+	 * \param position the position of the thumbnail.
+	 */
+	void thumbnailReady(qint64 position);
+
+	/*! \brief Notify the views of the thumbnails which became available.
+	 */
+	void updateThumbnails();
+
+protected:
+	ProjectManager& project;
+
+	// Number of rows made known to the views by each fetchMore
+	static constexpr int fetchedRows = 1'000;
+
+	// The number of rows the views know about, the first breakpoints
+	int rows = 0;
+
+	ThumbnailProvider* thumbnails = nullptr;
+	QImage placeholder;
+
+	// Thumbnails available since the last updateThumbnails
+	std::vector<qint64> readyThumbnails;
+	QTimer thumbnailsTimer;
+};
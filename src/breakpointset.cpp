@@ -0,0 +1,351 @@
+#include "breakpointset.hpp"
+
+#include <algorithm>
+#include <iterator>
+
+std::vector<qint64> regularBreakpoints(qint64 from, qint64 to, qint64 interval) {
+	std::vector<qint64> breakpoints;
+	if(interval <= 0 || to < from) {
+		return breakpoints;
+	}
+
+	breakpoints.reserve((to - from) / interval + 1);
+	for(qint64 breakpoint = from ; breakpoint <= to ; breakpoint += interval) {
+		breakpoints.push_back(breakpoint);
+	}
+	return breakpoints;
+}
+
+bool BreakpointsChange::empty() const {
+	return inserted.empty() && removed.empty();
+}
+
+BreakpointsChange BreakpointsChange::inverted() const {
+	return {removed, inserted};
+}
+
+void BreakpointsChange::merge(BreakpointsChange const& next) {
+	// A breakpoint inserted then removed (or the opposite) cancels out
+	std::vector<qint64> mergedInserted, mergedRemoved;
+
+	std::set_difference(inserted.cbegin(), inserted.cend(), next.removed.cbegin(),
+	                    next.removed.cend(), std::back_inserter(mergedInserted));
+	std::vector<qint64> nextInserted;
+	std::set_difference(next.inserted.cbegin(), next.inserted.cend(), removed.cbegin(),
+	                    removed.cend(), std::back_inserter(nextInserted));
+
+	std::set_difference(removed.cbegin(), removed.cend(), next.inserted.cbegin(),
+	                    next.inserted.cend(), std::back_inserter(mergedRemoved));
+	std::vector<qint64> nextRemoved;
+	std::set_difference(next.removed.cbegin(), next.removed.cend(), inserted.cbegin(),
+	                    inserted.cend(), std::back_inserter(nextRemoved));
+
+	inserted.clear();
+	std::set_union(mergedInserted.cbegin(), mergedInserted.cend(), nextInserted.cbegin(),
+	               nextInserted.cend(), std::back_inserter(inserted));
+	removed.clear();
+	std::set_union(mergedRemoved.cbegin(), mergedRemoved.cend(), nextRemoved.cbegin(),
+	               nextRemoved.cend(), std::back_inserter(removed));
+}
+
+BreakpointSet::BreakpointSet(std::vector<qint64> values)
+      : root() {
+	normalize(values);
+	if(!values.empty()) {
+		auto chunks = std::make_shared<Chunks>();
+		chunks->append(std::move(values));
+		root = std::move(chunks);
+	}
+}
+
+std::size_t BreakpointSet::size() const {
+	return root ? root->size : 0;
+}
+
+bool BreakpointSet::empty() const {
+	return !root;
+}
+
+qint64 BreakpointSet::at(std::size_t index) const {
+	std::size_t chunk = chunkOf(index);
+	return (*root->chunks[chunk])[index - root->offsets[chunk]];
+}
+
+bool BreakpointSet::contains(qint64 breakpoint) const {
+	std::size_t index = lowerBound(breakpoint);
+	return index < size() && at(index) == breakpoint;
+}
+
+std::size_t BreakpointSet::lowerBound(qint64 position) const {
+	if(!root) {
+		return 0;
+	}
+
+	// The first chunk ending at or after the position holds the result
+	auto const& chunks = root->chunks;
+	auto chunk = std::partition_point(chunks.cbegin(), chunks.cend(),
+	                                  [position](auto const& c) { return c->back() < position; });
+	if(chunk == chunks.cend()) {
+		return root->size;
+	}
+	return root->offsets[chunk - chunks.cbegin()] +
+	       (std::lower_bound((*chunk)->cbegin(), (*chunk)->cend(), position) - (*chunk)->cbegin());
+}
+
+std::size_t BreakpointSet::upperBound(qint64 position) const {
+	if(!root) {
+		return 0;
+	}
+
+	auto const& chunks = root->chunks;
+	auto chunk = std::partition_point(chunks.cbegin(), chunks.cend(),
+	                                  [position](auto const& c) { return c->back() <= position; });
+	if(chunk == chunks.cend()) {
+		return root->size;
+	}
+	return root->offsets[chunk - chunks.cbegin()] +
+	       (std::upper_bound((*chunk)->cbegin(), (*chunk)->cend(), position) - (*chunk)->cbegin());
+}
+
+std::size_t BreakpointSet::upperBound(qint64 position, std::size_t hint) const {
+	std::size_t size = this->size();
+	if(hint > size) {
+		hint = size;
+	}
+
+	if(hint < size && at(hint) <= position) {
+		// The result is after the hint
+		std::size_t step = 1;
+		while(hint + step < size && at(hint + step) <= position) {
+			step *= 2;
+		}
+		std::size_t first = hint + step / 2 + 1, last = std::min(hint + step, size);
+		while(first < last) {
+			std::size_t middle = first + (last - first) / 2;
+			if(at(middle) <= position) {
+				first = middle + 1;
+			} else {
+				last = middle;
+			}
+		}
+		return first;
+	} else if(hint > 0 && at(hint - 1) > position) {
+		// The result is before the hint
+		std::size_t step = 1;
+		while(step < hint && at(hint - 1 - step) > position) {
+			step *= 2;
+		}
+		std::size_t first = (step < hint) ? hint - step : 0, last = hint - 1 - step / 2;
+		while(first < last) {
+			std::size_t middle = first + (last - first) / 2;
+			if(at(middle) <= position) {
+				first = middle + 1;
+			} else {
+				last = middle;
+			}
+		}
+		return first;
+	}
+
+	return hint;
+}
+
+bool BreakpointSet::insert(qint64 breakpoint) {
+	if(contains(breakpoint)) {
+		return false;
+	}
+	modify({breakpoint}, {});
+	return true;
+}
+
+std::vector<qint64> BreakpointSet::insert(std::vector<qint64> const& breakpoints) {
+	std::vector<qint64> sorted(breakpoints);
+	normalize(sorted);
+
+	std::vector<qint64> inserted;
+	std::copy_if(sorted.cbegin(), sorted.cend(), std::back_inserter(inserted),
+	             [this](qint64 breakpoint) { return !contains(breakpoint); });
+
+	modify(inserted, {});
+	return inserted;
+}
+
+bool BreakpointSet::erase(qint64 breakpoint) {
+	if(!contains(breakpoint)) {
+		return false;
+	}
+	modify({}, {breakpoint});
+	return true;
+}
+
+std::vector<qint64> BreakpointSet::erase(std::vector<qint64> const& breakpoints) {
+	std::vector<qint64> sorted(breakpoints);
+	normalize(sorted);
+
+	std::vector<qint64> erased;
+	std::copy_if(sorted.cbegin(), sorted.cend(), std::back_inserter(erased),
+	             [this](qint64 breakpoint) { return contains(breakpoint); });
+
+	modify({}, erased);
+	return erased;
+}
+
+BreakpointsChange BreakpointSet::apply(BreakpointsChange const& change) {
+	// A breakpoint both removed and inserted is kept
+	std::vector<qint64> removed;
+	std::set_difference(change.removed.cbegin(), change.removed.cend(), change.inserted.cbegin(),
+	                    change.inserted.cend(), std::back_inserter(removed));
+
+	BreakpointsChange applied;
+	applied.removed = erase(removed);
+	applied.inserted = insert(change.inserted);
+	return applied;
+}
+
+BreakpointsChange BreakpointSet::changeTo(BreakpointSet const& other) const {
+	BreakpointsChange change;
+	if(root == other.root) {
+		return change;
+	}
+
+	std::set_difference(other.cbegin(), other.cend(), cbegin(), cend(),
+	                    std::back_inserter(change.inserted));
+	std::set_difference(cbegin(), cend(), other.cbegin(), other.cend(),
+	                    std::back_inserter(change.removed));
+	return change;
+}
+
+BreakpointSet::const_iterator BreakpointSet::begin() const {
+	return const_iterator(this, 0, 0);
+}
+
+BreakpointSet::const_iterator BreakpointSet::end() const {
+	return const_iterator(this, root ? root->chunks.size() : 0, size());
+}
+
+BreakpointSet::const_iterator BreakpointSet::cbegin() const {
+	return begin();
+}
+
+BreakpointSet::const_iterator BreakpointSet::cend() const {
+	return end();
+}
+
+bool BreakpointSet::operator==(BreakpointSet const& other) const {
+	return root == other.root ||
+	       (size() == other.size() && std::equal(cbegin(), cend(), other.cbegin()));
+}
+
+bool BreakpointSet::operator!=(BreakpointSet const& other) const {
+	return !(*this == other);
+}
+
+void BreakpointSet::normalize(std::vector<qint64>& values) {
+	std::sort(values.begin(), values.end());
+	values.erase(std::unique(values.begin(), values.end()), values.end());
+}
+
+void BreakpointSet::Chunks::append(std::shared_ptr<Chunk const> chunk) {
+	offsets.push_back(size);
+	size += chunk->size();
+	chunks.push_back(std::move(chunk));
+}
+
+void BreakpointSet::Chunks::append(Chunk&& values) {
+	if(values.size() <= maxChunkSize) {
+		if(!values.empty()) {
+			append(std::make_shared<Chunk>(std::move(values)));
+		}
+		return;
+	}
+
+	// Split evenly, so the chunks have room for the next insertions
+	std::size_t count = (values.size() + maxChunkSize - 1) / maxChunkSize;
+	for(std::size_t i = 0 ; i < count ; ++i) {
+		auto first = values.cbegin() + values.size() * i / count;
+		auto last = values.cbegin() + values.size() * (i + 1) / count;
+		append(std::make_shared<Chunk>(first, last));
+	}
+}
+
+void BreakpointSet::modify(std::vector<qint64> const& inserted,
+                           std::vector<qint64> const& removed) {
+	if(inserted.empty() && removed.empty()) {
+		return;
+	}
+
+	auto modified = std::make_shared<Chunks>();
+	if(!root) {
+		modified->append(Chunk(inserted));
+		root = std::move(modified);
+		return;
+	}
+
+	auto toInsert = inserted.cbegin();
+	auto toRemove = removed.cbegin();
+	std::size_t count = root->chunks.size();
+	modified->chunks.reserve(count + 1);
+	modified->offsets.reserve(count + 1);
+
+	// A rebuilt chunk too small to be kept, merged into the next one
+	Chunk pending;
+	for(std::size_t i = 0 ; i < count ; ++i) {
+		Chunk const& chunk = *root->chunks[i];
+
+		// Each chunk receives the breakpoints up to its last one, the last
+		// chunk also receives the ones after it
+		auto insertEnd = (i + 1 == count)
+		                   ? inserted.cend()
+		                   : std::upper_bound(toInsert, inserted.cend(), chunk.back());
+		auto removeEnd = std::upper_bound(toRemove, removed.cend(), chunk.back());
+
+		if(toInsert == insertEnd && toRemove == removeEnd && pending.empty()) {
+			modified->append(root->chunks[i]);
+			continue;
+		}
+
+		// The pending breakpoints are all before the ones of this chunk
+		Chunk kept = std::move(pending);
+		pending.clear();
+		kept.reserve(kept.size() + chunk.size());
+		std::set_difference(chunk.cbegin(), chunk.cend(), toRemove, removeEnd,
+		                    std::back_inserter(kept));
+
+		Chunk merged;
+		merged.reserve(kept.size() + (insertEnd - toInsert));
+		std::merge(kept.cbegin(), kept.cend(), toInsert, insertEnd, std::back_inserter(merged));
+		if(merged.size() < minChunkSize) {
+			pending = std::move(merged);
+		} else {
+			modified->append(std::move(merged));
+		}
+
+		toInsert = insertEnd;
+		toRemove = removeEnd;
+	}
+
+	if(!pending.empty()) {
+		// Merged into the previous chunk instead, if any
+		if(!modified->chunks.empty()) {
+			Chunk last(*modified->chunks.back());
+			modified->size -= last.size();
+			modified->chunks.pop_back();
+			modified->offsets.pop_back();
+
+			last.insert(last.end(), pending.cbegin(), pending.cend());
+			pending = std::move(last);
+		}
+		modified->append(std::move(pending));
+	}
+
+	if(modified->chunks.empty()) {
+		root.reset();
+	} else {
+		root = std::move(modified);
+	}
+}
+
+std::size_t BreakpointSet::chunkOf(std::size_t index) const {
+	auto const& offsets = root->offsets;
+	return std::upper_bound(offsets.cbegin(), offsets.cend(), index) - offsets.cbegin() - 1;
+}
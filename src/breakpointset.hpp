@@ -0,0 +1,279 @@
+#pragma once
+
+#include <QtGlobal>
+
+#include <iterator>
+#include <memory>
+#include <vector>
+
+/*! \brief A change made to a BreakpointSet.
+ *
+ * Only contains the breakpoints which were actually inserted or removed, so
+ * a change can be reverted by swapping the two. Both vectors are sorted.
+ */
+struct BreakpointsChange {
+	std::vector<qint64> inserted;
+	std::vector<qint64> removed;
+
+	/*! \brief Returns true if the change does nothing.
+	 */
+	bool empty() const;
+
+	/*! \brief Get the change reverting this one.
+	 */
+	BreakpointsChange inverted() const;
+
+	/*! \brief Append a change made right after this one.
+	 *
+	 * \param next the change made after this one.
+	 */
+	void merge(BreakpointsChange const& next);
+};
+
+/*! \brief Get breakpoints at a regular interval.
+ *
+ * \param from the position of the first breakpoint in msecs.
+ * \param to the position after which there is no breakpoint, in msecs.
+ * \param interval the interval between two breakpoints in msecs.
+ * \return the breakpoints, sorted. Empty if the interval is not positive.
+ */
+std::vector<qint64> regularBreakpoints(qint64 from, qint64 to, qint64 interval);
+
+/*! \brief Sorted set of breakpoints stored in shared chunks.
+ *
+ * Behaves like a std::set<qint64> but with random access by index and batch
+ * insertion/removal.
+ *
+ * The breakpoints are stored in sorted chunks of at most maxChunkSize
+ * breakpoints, which are never modified once built: a modification builds
+ * the chunks it touches again and shares the others with the previous
+ * version of the set. Copying a set (snapshots for the history, the autosave
+ * or a save in a worker thread) is therefore O(1), and a modification of a
+ * copied set only copies the list of the chunks and the modified chunks.
+ */
+class BreakpointSet {
+public:
+	/*! \brief Iterator over the breakpoints, in order.
+	 *
+	 * Invalidated by the modifications of the set.
+	 */
+	class const_iterator {
+	public:
+		using iterator_category = std::forward_iterator_tag;
+		using value_type = qint64;
+		using difference_type = std::ptrdiff_t;
+		using pointer = qint64 const*;
+		using reference = qint64 const&;
+
+		const_iterator() = default;
+
+		reference operator*() const {
+			return (*set->root->chunks[chunk])[offset];
+		}
+
+		const_iterator& operator++() {
+			++index;
+			if(++offset == set->root->chunks[chunk]->size()) {
+				++chunk;
+				offset = 0;
+			}
+			return *this;
+		}
+
+		const_iterator operator++(int) {
+			const_iterator previous = *this;
+			++*this;
+			return previous;
+		}
+
+		bool operator==(const_iterator const& other) const {
+			return index == other.index;
+		}
+
+		bool operator!=(const_iterator const& other) const {
+			return index != other.index;
+		}
+
+		//! The distance between two iterators of the same set.
+		difference_type operator-(const_iterator const& other) const {
+			return static_cast<difference_type>(index) - static_cast<difference_type>(other.index);
+		}
+
+	private:
+		friend class BreakpointSet;
+
+		const_iterator(BreakpointSet const* set, std::size_t chunk, std::size_t index)
+		      : set(set)
+		      , chunk(chunk)
+		      , index(index) {}
+
+		BreakpointSet const* set = nullptr;
+		std::size_t chunk = 0, offset = 0;
+		// Index of the breakpoint in the set
+		std::size_t index = 0;
+	};
+
+	//! Maximum number of breakpoints in a chunk.
+	static std::size_t const maxChunkSize = 512;
+
+	//! Minimum number of breakpoints in a rebuilt chunk, smaller ones are
+	//! merged with a neighbour.
+	static std::size_t const minChunkSize = maxChunkSize / 4;
+
+	/*! \brief BreakpointSet default constructor.
+	 *
+	 * Constructs an empty set.
+	 */
+	BreakpointSet() = default;
+
+	/*! \brief BreakpointSet constructor from arbitrary values.
+	 *
+	 * The values will be sorted and the duplicates removed.
+	 *
+	 * \param values the breakpoints in msecs.
+	 */
+	explicit BreakpointSet(std::vector<qint64> values);
+
+	/*! \brief Get the number of breakpoints.
+	 */
+	std::size_t size() const;
+
+	/*! \brief Returns true if there is no breakpoints.
+	 */
+	bool empty() const;
+
+	/*! \brief Get the breakpoint at the given index.
+	 *
+	 * \param index the index of the breakpoint, must be lower than size().
+	 * \return the breakpoint.
+	 */
+	qint64 at(std::size_t index) const;
+
+	/*! \brief Check if the given breakpoint is in the set.
+	 *
+	 * \param breakpoint the breakpoint to look for.
+	 * \return true if the breakpoint is in the set.
+	 */
+	bool contains(qint64 breakpoint) const;
+
+	/*! \brief Get the index of the first breakpoint not lower than position.
+	 *
+	 * \param position the position in msecs.
+	 * \return the index, size() if there is no such breakpoint.
+	 */
+	std::size_t lowerBound(qint64 position) const;
+
+	/*! \brief Get the index of the first breakpoint greater than position.
+	 *
+	 * \param position the position in msecs.
+	 * \return the index, size() if there is no such breakpoint.
+	 */
+	std::size_t upperBound(qint64 position) const;
+
+	/*! \brief Get the index of the first breakpoint greater than position,
+	 * starting the search from a previous result.
+	 *
+	 * Gallops from the hint, so the cost is logarithmic in the distance between
+	 * the hint and the result instead of the size of the set. The hint does not
+	 * need to be valid (e.g. if the set was modified since).
+	 *
+	 * \param position the position in msecs.
+	 * \param hint a previous result of upperBound.
+	 * \return the index, size() if there is no such breakpoint.
+	 */
+	std::size_t upperBound(qint64 position, std::size_t hint) const;
+
+	/*! \brief Insert a breakpoint.
+	 *
+	 * \param breakpoint the breakpoint to insert.
+	 * \return true if the breakpoint was not already in the set.
+	 */
+	bool insert(qint64 breakpoint);
+
+	/*! \brief Insert several breakpoints.
+	 *
+	 * \param breakpoints the breakpoints to insert, in any order.
+	 * \return the breakpoints which were not already in the set, sorted.
+	 */
+	std::vector<qint64> insert(std::vector<qint64> const& breakpoints);
+
+	/*! \brief Remove a breakpoint.
+	 *
+	 * \param breakpoint the breakpoint to remove.
+	 * \return true if the breakpoint was in the set.
+	 */
+	bool erase(qint64 breakpoint);
+
+	/*! \brief Remove several breakpoints.
+	 *
+	 * \param breakpoints the breakpoints to remove, in any order.
+	 * \return the breakpoints which were in the set, sorted.
+	 */
+	std::vector<qint64> erase(std::vector<qint64> const& breakpoints);
+
+	/*! \brief Apply a change to this set.
+	 *
+	 * \param change the change to apply.
+	 * \return the change which was actually applied.
+	 */
+	BreakpointsChange apply(BreakpointsChange const& change);
+
+	/*! \brief Compute the change transforming this set into an other.
+	 *
+	 * \param other the target set.
+	 * \return the change.
+	 */
+	BreakpointsChange changeTo(BreakpointSet const& other) const;
+
+	const_iterator begin() const;
+	const_iterator end() const;
+	const_iterator cbegin() const;
+	const_iterator cend() const;
+
+	bool operator==(BreakpointSet const& other) const;
+	bool operator!=(BreakpointSet const& other) const;
+
+protected:
+	/*! \brief Sort and remove the duplicates of a vector.
+	 */
+	static void normalize(std::vector<qint64>& values);
+
+	using Chunk = std::vector<qint64>;
+
+	/*! \brief The chunks of a version of the set.
+	 */
+	struct Chunks {
+		std::vector<std::shared_ptr<Chunk const>> chunks;
+		// The index of the first breakpoint of each chunk
+		std::vector<std::size_t> offsets;
+		std::size_t size = 0;
+
+		/*! \brief Append a chunk, which might be shared with other versions.
+		 */
+		void append(std::shared_ptr<Chunk const> chunk);
+
+		/*! \brief Append breakpoints, split in as many chunks as needed.
+		 */
+		void append(Chunk&& values);
+	};
+
+	/*! \brief Replace the current version by a modified one.
+	 *
+	 * Only the chunks containing inserted or removed breakpoints are built
+	 * again, along with the neighbours of the ones left with less than
+	 * minChunkSize breakpoints.
+	 *
+	 * \param inserted the breakpoints to insert, sorted and not in the set.
+	 * \param removed the breakpoints to remove, sorted and in the set.
+	 */
+	void modify(std::vector<qint64> const& inserted, std::vector<qint64> const& removed);
+
+	/*! \brief Get the index of the chunk containing a breakpoint.
+	 *
+	 * \param index the index of the breakpoint, must be lower than size().
+	 */
+	std::size_t chunkOf(std::size_t index) const;
+
+	// Never modified once built, null for an empty set
+	std::shared_ptr<Chunks const> root;
+};
@@ -0,0 +1,148 @@
+#include "breakpointsfile.hpp"
+
+#include <QFile>
+#include <QSaveFile>
+
+#include <algorithm>
+
+#include <stdexcept>
+
+namespace {
+	char const magic[] = {'S', 'L', 'D', 'B'};
+	quint64 const version = 1;
+
+	void writeVarint(QByteArray& out, quint64 value) {
+		while(value >= 0x80) {
+			out.append(static_cast<char>((value & 0x7f) | 0x80));
+			value >>= 7;
+		}
+		out.append(static_cast<char>(value));
+	}
+
+	quint64 readVarint(uchar const*& data, uchar const* end) {
+		quint64 value = 0;
+		for(int shift = 0 ; shift < 64 ; shift += 7) {
+			if(data == end) {
+				throw std::runtime_error("Truncated breakpoints file");
+			}
+			uchar byte = *data++;
+			value |= static_cast<quint64>(byte & 0x7f) << shift;
+			if(!(byte & 0x80)) {
+				return value;
+			}
+		}
+		throw std::runtime_error("Invalid varint in breakpoints file");
+	}
+
+	quint64 zigzagEncode(qint64 value) {
+		return (static_cast<quint64>(value) << 1) ^ static_cast<quint64>(value >> 63);
+	}
+
+	qint64 zigzagDecode(quint64 value) {
+		return static_cast<qint64>(value >> 1) ^ -static_cast<qint64>(value & 1);
+	}
+
+	// Check the magic and the version, then returns the breakpoint count
+	quint64 readHeader(uchar const*& data, uchar const* end) {
+		if(end - data < static_cast<std::ptrdiff_t>(sizeof(magic)) ||
+		   !std::equal(magic, magic + sizeof(magic), reinterpret_cast<char const*>(data))) {
+			throw std::runtime_error("Not a breakpoints file");
+		}
+		data += sizeof(magic);
+
+		if(readVarint(data, end) != version) {
+			throw std::runtime_error("Unsupported breakpoints file version");
+		}
+
+		return readVarint(data, end);
+	}
+}
+
+QByteArray BreakpointsFile::encode(BreakpointSet const& breakpoints) {
+	QByteArray out;
+	// Most deltas fit in 2 or 3 bytes
+	out.reserve(sizeof(magic) + 20 + breakpoints.size() * 3);
+
+	out.append(magic, sizeof(magic));
+	writeVarint(out, version);
+	writeVarint(out, breakpoints.size());
+
+	qint64 previous = 0;
+	bool first = true;
+	for(qint64 breakpoint : breakpoints) {
+		if(first) {
+			writeVarint(out, zigzagEncode(breakpoint));
+			first = false;
+		} else {
+			// Breakpoints are sorted and unique, so the delta is positive
+			writeVarint(out, static_cast<quint64>(breakpoint - previous));
+		}
+		previous = breakpoint;
+	}
+
+	return out;
+}
+
+BreakpointSet BreakpointsFile::decode(uchar const* data, qint64 size) {
+	uchar const* end = data + size;
+	quint64 count = readHeader(data, end);
+
+	// Each breakpoint takes at least one byte
+	if(count > static_cast<quint64>(end - data)) {
+		throw std::runtime_error("Truncated breakpoints file");
+	}
+
+	std::vector<qint64> values;
+	values.reserve(count);
+
+	qint64 previous = 0;
+	for(quint64 i = 0 ; i < count ; ++i) {
+		if(i == 0) {
+			previous = zigzagDecode(readVarint(data, end));
+		} else {
+			previous += static_cast<qint64>(readVarint(data, end));
+		}
+		values.push_back(previous);
+	}
+
+	return BreakpointSet(std::move(values));
+}
+
+quint64 BreakpointsFile::readCount(QString const& path) {
+	QFile file(path);
+	if(!file.open(QIODevice::ReadOnly)) {
+		throw std::runtime_error("Could not open " + path.toStdString());
+	}
+
+	// The header is at most the magic and two varints
+	QByteArray header = file.read(sizeof(magic) + 20);
+	uchar const* data = reinterpret_cast<uchar const*>(header.constData());
+	return readHeader(data, data + header.size());
+}
+
+BreakpointSet BreakpointsFile::read(QString const& path) {
+	QFile file(path);
+	if(!file.open(QIODevice::ReadOnly)) {
+		throw std::runtime_error("Could not open " + path.toStdString());
+	}
+
+	if(uchar* data = file.map(0, file.size())) {
+		BreakpointSet breakpoints = decode(data, file.size());
+		file.unmap(data);
+		return breakpoints;
+	}
+
+	// Not mappable (e.g. empty file), read it instead
+	QByteArray content = file.readAll();
+	return decode(reinterpret_cast<uchar const*>(content.constData()), content.size());
+}
+
+void BreakpointsFile::write(QString const& path, BreakpointSet const& breakpoints) {
+	QSaveFile file(path);
+	QByteArray content = encode(breakpoints);
+	if(!file.open(QIODevice::WriteOnly) || file.write(content) != content.size() ||
+	   !file.commit()) {
+		throw std::runtime_error("Could not write " + path.toStdString() + ": " +
+		                         file.errorString().toStdString());
+	}
+}
@@ -0,0 +1,68 @@
+#pragma once
+
+#include "breakpointset.hpp"
+
+#include <QByteArray>
+#include <QString>
+
+/*! \brief Compact binary storage of breakpoints.
+ *
+ * Used instead of the YAML "breakpoints" sequence for projects with a lot of
+ * breakpoints. The file contains:
+ *   - the magic "SLDB"
+ *   - the format version, as a varint
+ *   - the breakpoint count, as a varint
+ *   - the first breakpoint, zigzag encoded as a varint
+ *   - the difference between each breakpoint and the previous one, as varints
+ *
+ * Varints are little-endian base 128 (7 bits per byte, the high bit set on
+ * every byte but the last one).
+ */
+namespace BreakpointsFile {
+
+	/*! \brief Encode breakpoints in the binary format.
+	 *
+	 * \param breakpoints the breakpoints to encode.
+	 * \return the content of the file.
+	 */
+	QByteArray encode(BreakpointSet const& breakpoints);
+
+	/*! \brief Decode breakpoints from the binary format.
+	 *
+	 * Throws std::runtime_error if the data is not valid.
+	 *
+	 * \param data the content of the file.
+	 * \param size the size of the content.
+	 * \return the breakpoints.
+	 */
+	BreakpointSet decode(uchar const* data, qint64 size);
+
+	/*! \brief Read the breakpoint count of a file without decoding it.
+	 *
+	 * Throws std::runtime_error if the file cannot be read or is not valid.
+	 *
+	 * \param path the path of the file.
+	 * \return the number of breakpoints stored in the file.
+	 */
+	quint64 readCount(QString const& path);
+
+	/*! \brief Read breakpoints from a file.
+	 *
+	 * The file is memory-mapped when possible. Throws std::runtime_error if
+	 * the file cannot be read or is not valid.
+	 *
+	 * \param path the path of the file.
+	 * \return the breakpoints.
+	 */
+	BreakpointSet read(QString const& path);
+
+	/*! \brief Write breakpoints to a file.
+	 *
+	 * The breakpoints are written to a temporary file which then replaces the
+	 * file. Throws std::runtime_error if the file cannot be written.
+	 *
+	 * \param path the path of the file.
+	 * \param breakpoints the breakpoints to write.
+	 */
+	void write(QString const& path, BreakpointSet const& breakpoints);
+}
@@ -0,0 +1,107 @@
+#include "detectslidechangesdialog.hpp"
+
+#include "mainwindow.hpp"
+
+#include <QVBoxLayout>
+#include <QHBoxLayout>
+#include <QFormLayout>
+
+#include <QProgressDialog>
+#include <QFutureWatcher>
+
+DetectSlideChangesDialog::DetectSlideChangesDialog(QWidget& parent)
+      : QDialog(&parent)
+      , parent(parent)
+      , fromTime()
+      , toTime()
+      , minIntervalTime()
+      , thresholdSpinBox()
+      , cancelButton("Cancel")
+      , validateButton("OK") {
+	MainWindow& mwParent = dynamic_cast<MainWindow&>(parent);
+	SceneDetector::Settings defaults;
+
+	QVBoxLayout* mainLayout = new QVBoxLayout;
+
+	QTime endPosition = QTime(0, 0, 0, 0).addMSecs(mwParent.getVideoPlayer().getDuration());
+
+	QFormLayout* formLayout = new QFormLayout;
+	fromTime.setTime(QTime(0, 0, 0, 0));
+	fromTime.setDisplayFormat("HH:mm:ss.zzz");
+	formLayout->addRow("From: ", &fromTime);
+
+	toTime.setTime(endPosition);
+	toTime.setDisplayFormat("HH:mm:ss.zzz");
+	formLayout->addRow("To: ", &toTime);
+
+	thresholdSpinBox.setRange(1, 255);
+	thresholdSpinBox.setValue(defaults.threshold);
+	thresholdSpinBox.setToolTip("Mean difference between two frames above which the slide "
+	                            "changed. Lower it to detect more subtle changes.");
+	formLayout->addRow("Threshold: ", &thresholdSpinBox);
+
+	minIntervalTime.setTime(QTime(0, 0, 0, 0).addMSecs(defaults.minInterval));
+	minIntervalTime.setDisplayFormat("HH:mm:ss.zzz");
+	formLayout->addRow("Minimum interval: ", &minIntervalTime);
+
+	QWidget* formWidget = new QWidget;
+	formWidget->setLayout(formLayout);
+
+	QHBoxLayout* buttonsLayout = new QHBoxLayout;
+	buttonsLayout->addWidget(&cancelButton);
+	buttonsLayout->addWidget(&validateButton);
+
+	validateButton.setDefault(true);
+
+	QWidget* buttonsWidget = new QWidget;
+	buttonsWidget->setLayout(buttonsLayout);
+
+	mainLayout->addWidget(formWidget);
+	mainLayout->addWidget(buttonsWidget);
+
+	setLayout(mainLayout);
+	setWindowTitle("Detect slide changes");
+
+	connect(&cancelButton, SIGNAL(clicked()), this, SLOT(cancel()));
+	connect(&validateButton, SIGNAL(clicked()), this, SLOT(validate()));
+}
+
+void DetectSlideChangesDialog::cancel() {
+	done(1);
+}
+
+void DetectSlideChangesDialog::validate() {
+	MainWindow& mwParent = dynamic_cast<MainWindow&>(parent);
+
+	SceneDetector::Settings settings;
+	settings.from = getMSecs(fromTime);
+	settings.to = getMSecs(toTime);
+	settings.threshold = thresholdSpinBox.value();
+	settings.minInterval = getMSecs(minIntervalTime);
+
+	QFutureWatcher<std::vector<SceneDetector::Cut>> watcher;
+	QProgressDialog progress("Detecting slide changes...", "Cancel", 0, 0, this);
+	progress.setWindowModality(Qt::WindowModal);
+
+	connect(&watcher, SIGNAL(progressRangeChanged(int, int)), &progress, SLOT(setRange(int, int)));
+	connect(&watcher, SIGNAL(progressValueChanged(int)), &progress, SLOT(setValue(int)));
+	connect(&watcher, SIGNAL(finished()), &progress, SLOT(reset()));
+	connect(&progress, SIGNAL(canceled()), &watcher, SLOT(cancel()));
+
+	watcher.setFuture(SceneDetector::start(mwParent.getProject().getTimeline(), settings));
+	progress.exec();
+	watcher.waitForFinished();
+
+	if(watcher.isCanceled()) {
+		return;
+	}
+
+	// A single batch, undone at once
+	mwParent.addProjectBreakpoints(SceneDetector::breakpoints(watcher.future().results(), settings));
+
+	done(0);
+}
+
+inline qint64 DetectSlideChangesDialog::getMSecs(QTimeEdit const& timeEditor) const {
+	return QTime(0, 0, 0, 0).msecsTo(timeEditor.dateTime().time());
+}
@@ -0,0 +1,51 @@
+#pragma once
+
+#include "scenedetector.hpp"
+
+#include <QDialog>
+#include <QTimeEdit>
+#include <QSpinBox>
+#include <QPushButton>
+
+/*! \brief Dialog adding breakpoints at the slide changes of the video.
+ *
+ * The slide changes are detected with SceneDetector, a progress dialog is
+ * shown during the detection.
+ */
+class DetectSlideChangesDialog : public QDialog {
+
+	Q_OBJECT
+
+public:
+	/*! \brief DetectSlideChangesDialog constructor.
+	 *
+	 * \param parent the parent widget (the main window).
+	 */
+	DetectSlideChangesDialog(QWidget& parent);
+
+public slots:
+
+	/*! \brief Function called when the user cancels.
+	 */
+	virtual void cancel();
+
+	/*! \brief Function called when the user validates.
+	 *
+	 * This will detect the slide changes and add them as breakpoints.
+	 */
+	virtual void validate();
+
+protected:
+	/*! \brief Get a QTime as milliseconds.
+	 *
+	 * \param timeEditor the QTime to convert.
+	 * \return the milliseconds.
+	 */
+	inline qint64 getMSecs(QTimeEdit const& timeEditor) const;
+
+	QWidget& parent;
+
+	QTimeEdit fromTime, toTime, minIntervalTime;
+	QSpinBox thresholdSpinBox;
+	QPushButton cancelButton, validateButton;
+};
@@ -0,0 +1,137 @@
+#include "framecache.hpp"
+
+#include <QtConcurrent>
+
+// std::find
+#include <algorithm>
+#include <exception>
+
+FrameCache::FrameCache(QObject* parent)
+      : QObject(parent)
+      , decoder(std::make_shared<std::unique_ptr<TimelineDecoder>>()) {
+	connect(&decodeWatcher, SIGNAL(finished()), this, SLOT(finishDecoding()));
+}
+
+FrameCache::~FrameCache() {
+	pending.clear();
+	decodeWatcher.waitForFinished();
+}
+
+void FrameCache::setTimeline(Timeline const& timeline) {
+	clear();
+	this->timeline = timeline;
+	// The running job keeps the previous decoder alive
+	decoder = std::make_shared<std::unique_ptr<TimelineDecoder>>();
+}
+
+void FrameCache::setFrameSize(QSize size) {
+	frameSize = size;
+}
+
+void FrameCache::setFramesPerBreakpoint(int count) {
+	framesPerBreakpoint = std::max(count, 1);
+}
+
+void FrameCache::setMemoryLimit(qint64 bytes) {
+	memoryLimit = bytes;
+	evict();
+}
+
+std::vector<FrameCache::Frame> const* FrameCache::find(qint64 breakpoint) {
+	auto it = index.find(breakpoint);
+	if(it == index.end()) {
+		return nullptr;
+	}
+
+	entries.splice(entries.begin(), entries, it->second);
+	return &it->second->frames;
+}
+
+void FrameCache::prefetch(std::vector<qint64> const& breakpoints) {
+	pending.clear();
+	for(qint64 breakpoint : breakpoints) {
+		auto it = index.find(breakpoint);
+		if(it != index.end()) {
+			// Keep it from being evicted by the frames about to be decoded
+			entries.splice(entries.begin(), entries, it->second);
+		} else if(breakpoint != decoding) {
+			pending.push_back(breakpoint);
+		}
+	}
+
+	if(!decodeWatcher.isRunning()) {
+		decodeNext();
+	}
+}
+
+void FrameCache::clear() {
+	pending.clear();
+	entries.clear();
+	index.clear();
+	usedMemory = 0;
+	// Discard the result of the running job
+	decoding = -1;
+}
+
+void FrameCache::finishDecoding() {
+	Frames frames = decodeWatcher.result();
+
+	if(decoding >= 0 && !frames.empty() && index.find(decoding) == index.end()) {
+		qint64 bytes = 0;
+		for(Frame const& frame : frames) {
+			bytes += frame.image.sizeInBytes();
+		}
+
+		entries.push_front({decoding, std::move(frames), bytes});
+		index[decoding] = entries.begin();
+		usedMemory += bytes;
+
+		qint64 breakpoint = decoding;
+		evict();
+		emit framesDecoded(breakpoint);
+	}
+
+	decoding = -1;
+	decodeNext();
+}
+
+void FrameCache::decodeNext() {
+	if(pending.empty() || timeline.empty()) {
+		return;
+	}
+
+	decoding = pending.front();
+	pending.pop_front();
+
+	decodeWatcher.setFuture(QtConcurrent::run(
+	  [decoder = this->decoder, timeline = this->timeline, breakpoint = decoding,
+	   count = framesPerBreakpoint, size = frameSize]() {
+		  Frames frames;
+		  try {
+			  if(!*decoder) {
+				  decoder->reset(new TimelineDecoder(timeline));
+			  }
+			  TimelineDecoder& videoDecoder = **decoder;
+
+			  if(!videoDecoder.decodeFrameAt(breakpoint)) {
+				  return frames;
+			  }
+			  do {
+				  frames.push_back({videoDecoder.getFramePosition(), videoDecoder.getFrameImage(size)});
+			  } while(static_cast<int>(frames.size()) < count && videoDecoder.decodeNextFrame());
+		  } catch(std::exception const&) {
+			  // The video cannot be decoded, the player will show it instead
+		  }
+		  return frames;
+	  }));
+}
+
+void FrameCache::evict() {
+	// Never evict the most recently used entry, even if it is over the limit
+	while(usedMemory > memoryLimit && entries.size() > 1) {
+		Entry const& entry = entries.back();
+		usedMemory -= entry.bytes;
+		index.erase(entry.breakpoint);
+		entries.pop_back();
+	}
+}
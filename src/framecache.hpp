@@ -0,0 +1,154 @@
+#pragma once
+
+#include "timelinedecoder.hpp"
+
+#include <QObject>
+
+#include <QFutureWatcher>
+
+#include <QImage>
+#include <QSize>
+#include <QString>
+
+#include <deque>
+#include <list>
+#include <map>
+#include <memory>
+#include <vector>
+
+/*! \brief Class used to keep the first frames after breakpoints in memory.
+ *
+ * The frames are decoded in the background, one breakpoint at a time, so they
+ * can be shown right away when the player jumps to or resumes from a
+ * breakpoint, while the player itself is still seeking/decoding.
+ *
+ * The least recently used breakpoints are evicted once the memory limit is
+ * exceeded.
+ */
+class FrameCache : public QObject {
+
+	Q_OBJECT
+
+public:
+	/*! \brief A decoded frame and its position in msecs.
+	 */
+	struct Frame {
+		qint64 position;
+		QImage image;
+	};
+
+	/*! \brief FrameCache constructor.
+	 *
+	 * \param parent the parent QObject.
+	 */
+	explicit FrameCache(QObject* parent = nullptr);
+
+	/*! \brief FrameCache destructor.
+	 *
+	 * Waits for the frames being decoded.
+	 */
+	~FrameCache();
+
+	/*! \brief Set the clips to decode the frames from.
+	 *
+	 * Clears the cache.
+	 *
+	 * \param timeline the clips of the project.
+	 */
+	void setTimeline(Timeline const& timeline);
+
+	/*! \brief Set the size of the decoded frames.
+	 *
+	 * Only applies to the frames decoded afterwards.
+	 *
+	 * \param size the size in which the frames must fit.
+	 */
+	void setFrameSize(QSize size);
+
+	/*! \brief Set the number of frames decoded after each breakpoint.
+	 *
+	 * Only applies to the frames decoded afterwards.
+	 */
+	void setFramesPerBreakpoint(int count);
+
+	/*! \brief Set the maximum memory used by the decoded frames.
+	 *
+	 * \param bytes the limit in bytes.
+	 */
+	void setMemoryLimit(qint64 bytes);
+
+	/*! \brief Get the frames decoded after a breakpoint.
+	 *
+	 * Marks the breakpoint as recently used.
+	 *
+	 * \param breakpoint the breakpoint in msecs.
+	 * \return the frames, or nullptr if they are not decoded yet. The pointer
+	 *         is invalidated by any non-const call.
+	 */
+	std::vector<Frame> const* find(qint64 breakpoint);
+
+	/*! \brief Decode the frames after the given breakpoints in the background.
+	 *
+	 * Replaces the previously requested breakpoints that were not decoded yet.
+	 *
+	 * \param breakpoints the breakpoints, the most urgent first.
+	 */
+	void prefetch(std::vector<qint64> const& breakpoints);
+
+	/*! \brief Remove all the decoded frames.
+	 */
+	void clear();
+
+signals:
+	/*! \brief Emitted when the frames after a breakpoint have been decoded.
+	 *
+	 * \param breakpoint the breakpoint in msecs.
+	 */
+	void framesDecoded(qint64 breakpoint);
+
+protected slots:
+	/*! \brief Store the frames decoded in the background.
+	 *
+	 * Then starts decoding the next requested breakpoint.
+	 */
+	void finishDecoding();
+
+protected:
+	using Frames = std::vector<Frame>;
+
+	struct Entry {
+		qint64 breakpoint;
+		Frames frames;
+		qint64 bytes;
+	};
+
+	/*! \brief Start decoding the next requested breakpoint, if any.
+	 */
+	void decodeNext();
+
+	/*! \brief Remove the least recently used entries until the memory used is
+	 * under the limit.
+	 */
+	void evict();
+
+	Timeline timeline;
+	QSize frameSize = QSize(1920, 1080);
+	int framesPerBreakpoint = 1;
+	qint64 memoryLimit = 64 * 1024 * 1024;
+	qint64 usedMemory = 0;
+
+	/*! \brief The entries, the most recently used first.
+	 */
+	std::list<Entry> entries;
+	std::map<qint64, std::list<Entry>::iterator> index;
+
+	std::deque<qint64> pending;
+	qint64 decoding = -1;
+
+	/*! \brief Decoder kept open between jobs.
+	 *
+	 * Only used by the job in progress; jobs never run concurrently.
+	 */
+	std::shared_ptr<std::unique_ptr<TimelineDecoder>> decoder;
+	QFutureWatcher<Frames> decodeWatcher;
+};
@@ -1,43 +1,116 @@
 #include "history.hpp"
 
-History::History(ProjectManager& firstState)
-      : states{std::move(firstState)}
-      , currentState(states.begin())
-      , savedState(firstState.isSaved() ? states.begin() : states.end()) {}
-
-ProjectManager History::getCurrentState() const {
-	if(currentState == savedState) {
-		currentState->saved = true;
-	} else {
-		currentState->saved = false;
+constexpr std::size_t History::noState;
+
+History::History(ProjectManager const& firstState)
+      : savedState(firstState.isSaved() ? 0 : noState) {}
+
+bool History::goBack(ProjectManager& project) {
+	if(currentState == 0) {
+		return false;
 	}
-	return *currentState;
+
+	replaying = true;
+	project.applyChange(changes[currentState - 1].inverted());
+	replaying = false;
+
+	--currentState;
+	lastPush.invalidate();
+	updateSaved(project);
+	return true;
 }
 
-ProjectManager History::goBack() {
-	if(currentState != states.begin()) {
-		--currentState;
+bool History::advance(ProjectManager& project) {
+	if(currentState == changes.size()) {
+		return false;
 	}
-	return getCurrentState();
+
+	replaying = true;
+	project.applyChange(changes[currentState]);
+	replaying = false;
+
+	++currentState;
+	lastPush.invalidate();
+	updateSaved(project);
+	return true;
 }
 
-ProjectManager History::advance() {
-	if(currentState != --states.end()) {
-		++currentState;
+void History::push_back(BreakpointsChange const& change) {
+	if(replaying || change.empty()) {
+		return;
+	}
+
+	while(changes.size() > currentState) {
+		usedMemory -= memoryUsage(changes.back());
+		changes.pop_back();
+	}
+	if(savedState != noState && savedState > currentState) {
+		savedState = noState;
 	}
-	return getCurrentState();
-}
 
-void History::push_back(ProjectManager const& state) {
-	if(currentState != --states.end()) {
-		size_t newSize = std::distance(states.begin(), currentState) + 1;
-		states.resize(newSize);
+	bool coalesce = coalescingInterval > 0 && currentState > 0 && currentState != savedState &&
+	                lastPush.isValid() && !lastPush.hasExpired(coalescingInterval);
+
+	if(coalesce) {
+		usedMemory -= memoryUsage(changes.back());
+		changes.back().merge(change);
+		usedMemory += memoryUsage(changes.back());
+	} else {
+		changes.push_back(change);
+		usedMemory += memoryUsage(change);
+		++currentState;
 	}
 
-	states.push_back(state);
-	currentState = --states.end();
+	lastPush.start();
+	enforceMemoryLimit();
 }
 
 void History::setSaved() {
 	savedState = currentState;
+	lastPush.invalidate();
+}
+
+void History::setSaved(std::size_t state) {
+	if(state < droppedStates || state - droppedStates > changes.size()) {
+		// Dropped or undone then overwritten
+		savedState = noState;
+	} else {
+		savedState = state - droppedStates;
+	}
+}
+
+std::size_t History::checkpoint() {
+	lastPush.invalidate();
+	return droppedStates + currentState;
+}
+
+void History::setMemoryLimit(std::size_t bytes) {
+	memoryLimit = bytes;
+	enforceMemoryLimit();
+}
+
+void History::setCoalescingInterval(qint64 msecs) {
+	coalescingInterval = msecs;
+}
+
+std::size_t History::memoryUsage(BreakpointsChange const& change) {
+	return sizeof(BreakpointsChange) +
+	       (change.inserted.capacity() + change.removed.capacity()) * sizeof(qint64);
+}
+
+void History::enforceMemoryLimit() {
+	// Always keep the last change so it can be undone
+	while(usedMemory > memoryLimit && changes.size() > 1 && currentState > 0) {
+		usedMemory -= memoryUsage(changes.front());
+		changes.pop_front();
+		--currentState;
+		++droppedStates;
+		if(savedState != noState) {
+			savedState = (savedState == 0) ? noState : savedState - 1;
+		}
+	}
+}
+
+void History::updateSaved(ProjectManager& project) const {
+	project.saved = (currentState == savedState);
 }
@@ -2,12 +2,14 @@
 
 #include "projectmanager.hpp"
 
-#include <list>
+#include <QElapsedTimer>
+
+#include <deque>
 
 /*! \brief Class used to undo/redo in the project.
  *
- * This store a list of ProjectManager and alternate between nodes on
- * undo/redo.
+ * This store a list of changes made to the project's breakpoints and applies
+ * them in place, forward or backward, on undo/redo.
  */
 class History {
 public:
@@ -15,7 +17,7 @@ public:
 	 *
 	 * Will construct a history with one state.
 	 */
-	History(ProjectManager& firstState);
+	explicit History(ProjectManager const& firstState);
 
 	/*! \brief History default constructor.
 	 *
@@ -23,38 +25,91 @@ public:
 	 */
 	History() = default;
 
-	/*! \brief Get the current state of the project.
-	 *
-	 * This might NOT return the last state in the list
-	 * (ex: if the user has undo).
-	 *
-	 * \return a copy of the current state.
-	 */
-	ProjectManager getCurrentState() const;
-
 	/*! \brief Go back in the history by one.
 	 *
-	 * \return a copy of the current state after going back.
+	 * \param project the project to revert the last change on.
+	 * \return false if there was nothing to undo.
 	 */
-	ProjectManager goBack();
+	bool goBack(ProjectManager& project);
 
 	/*! \brief Advance in the history by one.
 	 *
-	 * \return a copy of the current state after advancing.
+	 * \param project the project to re-apply the next change on.
+	 * \return false if there was nothing to redo.
 	 */
-	ProjectManager advance();
+	bool advance(ProjectManager& project);
 
-	/*! \brief Add a new state at the next position.
+	/*! \brief Add a new change at the next position.
+	 *
+	 * If the previous change was pushed less than coalescingInterval msecs
+	 * ago, both are merged into a single one.
 	 *
-	 * \param state the state to add.
+	 * Ignored if the change comes from goBack/advance.
+	 *
+	 * \param change the change to add.
 	 */
-	void push_back(ProjectManager const& state);
+	void push_back(BreakpointsChange const& change);
 
 	/*! \brief Set the current state as "saved".
 	 */
 	void setSaved();
+
+	/*! \brief Set a previous state as "saved".
+	 *
+	 * \param state a state returned by checkpoint.
+	 */
+	void setSaved(std::size_t state);
+
+	/*! \brief Get an identifier of the current state.
+	 *
+	 * The next change will not be merged into the current state, so it can be
+	 * set as "saved" later, e.g. when an asynchronous save is done.
+	 *
+	 * \return the identifier of the current state.
+	 */
+	std::size_t checkpoint();
+
+	/*! \brief Set the maximum memory used by the stored changes.
+	 *
+	 * The oldest changes are dropped when this limit is exceeded.
+	 *
+	 * \param bytes the limit in bytes.
+	 */
+	void setMemoryLimit(std::size_t bytes);
+
+	/*! \brief Set the interval under which consecutive changes are merged.
+	 *
+	 * \param msecs the interval in msecs, 0 to disable coalescing.
+	 */
+	void setCoalescingInterval(qint64 msecs);
+
 protected:
-	std::list<ProjectManager> states;
-	std::list<ProjectManager>::iterator currentState;
-	std::list<ProjectManager>::iterator savedState;
+	/*! \brief Approximative memory used by a change.
+	 */
+	static std::size_t memoryUsage(BreakpointsChange const& change);
+
+	/*! \brief Drop the oldest changes until the memory limit is respected.
+	 */
+	void enforceMemoryLimit();
+
+	/*! \brief Update the project's "saved" state according to the current state.
+	 */
+	void updateSaved(ProjectManager& project) const;
+
+	static constexpr std::size_t noState = -1;
+
+	std::deque<BreakpointsChange> changes;
+	// States are numbered by the number of changes applied since the first one
+	std::size_t currentState = 0;
+	std::size_t savedState = noState;
+	// Number of changes dropped because of the memory limit
+	std::size_t droppedStates = 0;
+
+	std::size_t usedMemory = 0;
+	std::size_t memoryLimit = 64 * 1024 * 1024;
+
+	qint64 coalescingInterval = 300;
+	QElapsedTimer lastPush;
+
+	bool replaying = false;
 };
@@ -0,0 +1,163 @@
+#include "keyframeindex.hpp"
+
+#include "timelinedecoder.hpp"
+
+#include <QDataStream>
+#include <QDateTime>
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace {
+	quint32 const magic = 0x534c444b; // "SLDK"
+	quint32 const version = 2;
+}
+
+KeyframeIndex::KeyframeIndex(std::vector<qint64> keyframes, double frameDuration)
+      : keyframes(std::move(keyframes))
+      , frameDuration(frameDuration) {}
+
+KeyframeIndex KeyframeIndex::build(Timeline const& timeline) {
+	TimelineDecoder decoder(timeline);
+	qint64 frameCount = 0;
+	std::vector<qint64> keyframes = decoder.scanKeyframes(frameCount);
+
+	double frameDuration =
+	  (frameCount > 0) ? static_cast<double>(decoder.getDuration()) / frameCount : 0;
+	return KeyframeIndex(std::move(keyframes), frameDuration);
+}
+
+KeyframeIndex KeyframeIndex::load(QString const& indexFile, Timeline const& timeline) {
+	QFile file(indexFile);
+	if(!file.open(QIODevice::ReadOnly)) {
+		throw std::runtime_error("Could not open " + indexFile.toStdString());
+	}
+
+	QDataStream in(&file);
+	in.setVersion(QDataStream::Qt_5_0);
+
+	quint32 fileMagic, fileVersion;
+	in >> fileMagic >> fileVersion;
+	if(fileMagic != magic || fileVersion != version) {
+		throw std::runtime_error("Not a keyframe index file");
+	}
+
+	// Clips might have been added or replaced since the index was built
+	quint32 clipCount;
+	in >> clipCount;
+	if(clipCount != timeline.size()) {
+		throw std::runtime_error("Outdated keyframe index file");
+	}
+	for(std::size_t i = 0 ; i < timeline.size() ; ++i) {
+		QFileInfo videoInfo(timeline.at(i).file);
+		qint64 videoSize, videoModified;
+		in >> videoSize >> videoModified;
+		if(videoSize != videoInfo.size() ||
+		   videoModified != videoInfo.lastModified().toMSecsSinceEpoch()) {
+			throw std::runtime_error("Outdated keyframe index file");
+		}
+	}
+
+	double frameDuration;
+	quint32 count;
+	in >> frameDuration >> count;
+
+	std::vector<qint64> keyframes;
+	keyframes.reserve(std::min<quint32>(count, file.size() / sizeof(qint64)));
+	for(quint32 i = 0 ; i < count && in.status() == QDataStream::Ok ; ++i) {
+		qint64 keyframe;
+		in >> keyframe;
+		keyframes.push_back(keyframe);
+	}
+
+	if(in.status() != QDataStream::Ok) {
+		throw std::runtime_error("Truncated keyframe index file");
+	}
+
+	return KeyframeIndex(std::move(keyframes), frameDuration);
+}
+
+KeyframeIndex KeyframeIndex::loadOrBuild(QString const& indexFile, Timeline const& timeline) {
+	try {
+		return load(indexFile, timeline);
+	} catch(std::runtime_error const&) {
+		// Missing or outdated
+	}
+
+	KeyframeIndex index = build(timeline);
+	try {
+		index.save(indexFile, timeline);
+	} catch(std::runtime_error const&) {
+		// Will be built again next time
+	}
+	return index;
+}
+
+void KeyframeIndex::save(QString const& indexFile, Timeline const& timeline) const {
+	QSaveFile file(indexFile);
+	if(!file.open(QIODevice::WriteOnly)) {
+		throw std::runtime_error("Could not open " + indexFile.toStdString());
+	}
+
+	QDataStream out(&file);
+	out.setVersion(QDataStream::Qt_5_0);
+
+	out << magic << version << static_cast<quint32>(timeline.size());
+	for(std::size_t i = 0 ; i < timeline.size() ; ++i) {
+		QFileInfo videoInfo(timeline.at(i).file);
+		out << videoInfo.size() << videoInfo.lastModified().toMSecsSinceEpoch();
+	}
+	out << frameDuration << static_cast<quint32>(keyframes.size());
+	for(qint64 keyframe : keyframes) {
+		out << keyframe;
+	}
+
+	if(!file.commit()) {
+		throw std::runtime_error("Could not write " + indexFile.toStdString());
+	}
+}
+
+bool KeyframeIndex::empty() const {
+	return keyframes.empty();
+}
+
+std::size_t KeyframeIndex::size() const {
+	return keyframes.size();
+}
+
+qint64 KeyframeIndex::keyframeBefore(qint64 position) const {
+	auto it = std::upper_bound(keyframes.cbegin(), keyframes.cend(), position);
+	if(it == keyframes.cbegin()) {
+		return empty() ? position : keyframes.front();
+	}
+	return *(it - 1);
+}
+
+qint64 KeyframeIndex::nearestKeyframe(qint64 position) const {
+	if(empty()) {
+		return position;
+	}
+
+	auto it = std::lower_bound(keyframes.cbegin(), keyframes.cend(), position);
+	if(it == keyframes.cend()) {
+		return keyframes.back();
+	} else if(it == keyframes.cbegin() || *it - position < position - *(it - 1)) {
+		return *it;
+	}
+	return *(it - 1);
+}
+
+qint64 KeyframeIndex::seekCost(qint64 position) const {
+	if(frameDuration <= 0) {
+		return 0;
+	}
+	return std::llround(std::max<qint64>(position - keyframeBefore(position), 0) / frameDuration);
+}
+
+double KeyframeIndex::getFrameDuration() const {
+	return frameDuration;
+}
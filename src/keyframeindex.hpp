@@ -0,0 +1,109 @@
+#pragma once
+
+#include "timeline.hpp"
+
+#include <QString>
+
+#include <vector>
+
+/*! \brief Index of the keyframes of the clips of a timeline.
+ *
+ * QMediaPlayer seeks by decoding from the keyframe before the target, so the
+ * index is used to estimate the cost of a seek and to find cheap seek
+ * targets.
+ *
+ * Building the index only demuxes the video. It is cached in a file, see
+ * loadOrBuild.
+ */
+class KeyframeIndex {
+public:
+	/*! \brief KeyframeIndex default constructor.
+	 *
+	 * Constructs an empty index, in which every position is a keyframe.
+	 */
+	KeyframeIndex() = default;
+
+	/*! \brief KeyframeIndex constructor.
+	 *
+	 * \param keyframes the positions of the keyframes in msecs, sorted.
+	 * \param frameDuration the average duration of a frame in msecs.
+	 */
+	KeyframeIndex(std::vector<qint64> keyframes, double frameDuration);
+
+	/*! \brief Build the index of a timeline.
+	 *
+	 * Throws std::runtime_error if a clip cannot be read.
+	 *
+	 * \param timeline the indexed clips.
+	 * \return the index.
+	 */
+	static KeyframeIndex build(Timeline const& timeline);
+
+	/*! \brief Load an index from a file.
+	 *
+	 * Throws std::runtime_error if the file cannot be read, or if it was built
+	 * for other clips or another version of the video files.
+	 *
+	 * \param indexFile the path of the index file.
+	 * \param timeline the indexed clips.
+	 * \return the index.
+	 */
+	static KeyframeIndex load(QString const& indexFile, Timeline const& timeline);
+
+	/*! \brief Load an index from a file, or build it if needed.
+	 *
+	 * A built index is saved to the index file, errors while saving it are
+	 * ignored. Throws std::runtime_error if a clip cannot be read.
+	 *
+	 * \param indexFile the path of the index file.
+	 * \param timeline the indexed clips.
+	 * \return the index.
+	 */
+	static KeyframeIndex loadOrBuild(QString const& indexFile, Timeline const& timeline);
+
+	/*! \brief Save the index to a file.
+	 *
+	 * Throws std::runtime_error if the file cannot be written.
+	 *
+	 * \param indexFile the path of the index file.
+	 * \param timeline the indexed clips.
+	 */
+	void save(QString const& indexFile, Timeline const& timeline) const;
+
+	/*! \brief Returns true if the index contains no keyframe.
+	 */
+	bool empty() const;
+
+	/*! \brief Get the number of keyframes.
+	 */
+	std::size_t size() const;
+
+	/*! \brief Get the last keyframe not after the given position.
+	 *
+	 * \param position the position in msecs.
+	 * \return the keyframe, or position if the index is empty.
+	 */
+	qint64 keyframeBefore(qint64 position) const;
+
+	/*! \brief Get the keyframe closest to the given position.
+	 *
+	 * \param position the position in msecs.
+	 * \return the keyframe, or position if the index is empty.
+	 */
+	qint64 nearestKeyframe(qint64 position) const;
+
+	/*! \brief Estimate the number of frames decoded when seeking.
+	 *
+	 * \param position the target of the seek in msecs.
+	 * \return the number of frames between the previous keyframe and position.
+	 */
+	qint64 seekCost(qint64 position) const;
+
+	/*! \brief Get the average duration of a frame in msecs.
+	 */
+	double getFrameDuration() const;
+
+protected:
+	std::vector<qint64> keyframes;
+	double frameDuration = 0;
+};
@@ -1,7 +1,14 @@
 #include <QApplication>
 #include "mainwindow.hpp"
+#include "batch.hpp"
 
 int main(int argc, char* argv[]) {
+	if(Batch::isRequested(argc, argv)) {
+		QCoreApplication app(argc, argv);
+		app.setApplicationName("Slideo");
+		return Batch::run(app);
+	}
+
 	QApplication app(argc, argv);
 
 	app.setApplicationName("Slideo");
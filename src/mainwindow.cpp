@@ -2,6 +2,9 @@
 
 #include "timeselectdialog.hpp"
 #include "addbreakpointregularlydialog.hpp"
+#include "detectslidechangesdialog.hpp"
+#include "projectlibrarydialog.hpp"
+#include "videodecoder.hpp"
 
 #include <QApplication>
 
@@ -13,6 +16,7 @@
 
 #include <QStatusBar>
 #include <QMenuBar>
+#include <QActionGroup>
 #include <QToolBar>
 #include <QDockWidget>
 
@@ -20,29 +24,43 @@
 
 #include <QCloseEvent>
 
-#include <iterator>
+#include <QGuiApplication>
+#include <QScreen>
+#include <QWindow>
+
+#include <stdexcept>
+
 
 MainWindow::MainWindow()
       : QMainWindow(0)
       , videoPlayer(*this)
+      , presentationPlayer(*this, /* position = */ 0, /* presentationMode = */ true)
+      , autosave(project)
       , undoAction(QIcon::fromTheme("edit-undo"), "&Undo", this)
       , redoAction(QIcon::fromTheme("edit-redo"), "&Redo", this)
       , addBreakpointAction(QIcon::fromTheme("list-add"), "&Add breakpoint", this)
       , addBreakpointHereAction("Add breakpoint at &current position", this)
       , addBreakpointRegularly("Add breakpoint &regularly", this)
+      , detectSlideChangesAction("&Detect slide changes", this)
       , removeBreakpointAction(QIcon::fromTheme("list-remove"), "&Remove selected breakpoint(s)",
                                this)
+      , snapToKeyframesAction("&Snap breakpoints to keyframes", this)
       , playerPlayPauseButton(QIcon::fromTheme("media-playback-start"), "")
-      , playerSeekBar(Qt::Horizontal)
+      , playerSeekBar()
       , playerPositionViewer("00:00:00")
       , playerDurationViewer("00:00:00.000")
       , breakpointListView()
-      , breakpointListModel() {
+      , seekPreview()
+      , thumbnailProvider()
+      , breakpointListModel(project)
+      , presenterConsole(project, presentationPlayer, breakpointListModel, this) {
 	initCentralZone();
 	initActionWidgets();
 
 	updateWindowTitle();
 	connect(this, SIGNAL(projectActivated(bool)), this, SLOT(updateWindowTitle()));
+	connect(&autosave, SIGNAL(journalFailed(QString const&)), statusBar(),
+	        SLOT(showMessage(QString const&)));
 
 	statusBar()->showMessage("");
 	resize(800, 600);
@@ -60,14 +78,12 @@ void MainWindow::initCentralZone() {
 
 	connect(&videoPlayer.getPlayer(), SIGNAL(stateChanged(QMediaPlayer::State)), this,
 	        SLOT(updatePlayPauseButtonIcon(QMediaPlayer::State)));
-	connect(&videoPlayer.getPlayer(), SIGNAL(durationChanged(qint64)), this,
-	        SLOT(updateSliderRange(qint64)));
-	connect(&videoPlayer.getPlayer(), SIGNAL(durationChanged(qint64)), this,
-	        SLOT(updateDurationViewer(qint64)));
-	connect(&videoPlayer.getPlayer(), SIGNAL(positionChanged(qint64)), this,
-	        SLOT(updateSliderPosition(qint64)));
-	connect(&videoPlayer.getPlayer(), SIGNAL(positionChanged(qint64)), this,
-	        SLOT(updatePositionViewer(qint64)));
+	connect(&videoPlayer, SIGNAL(durationChanged(qint64)), this, SLOT(updateSliderRange(qint64)));
+	connect(&videoPlayer, SIGNAL(durationChanged(qint64)), this, SLOT(updateDurationViewer(qint64)));
+	connect(&videoPlayer, SIGNAL(positionChanged(qint64)), this, SLOT(updateSliderPosition(qint64)));
+	connect(&videoPlayer, SIGNAL(positionChanged(qint64)), this, SLOT(updatePositionViewer(qint64)));
+	connect(&videoPlayer.getPlayer(), SIGNAL(stateChanged(QMediaPlayer::State)), this,
+	        SLOT(preparePresentation(QMediaPlayer::State)));
 
 	// }}}
 
@@ -96,9 +112,11 @@ void MainWindow::initCentralZone() {
 
 	playerSeekBar.setRange(0, 0);
 	playerSeekBar.setEnabled(false);
-	connect(&playerSeekBar, SIGNAL(sliderMoved(int)), &videoPlayer, SLOT(setPosition(int)));
+	playerSeekBar.setPreview(&seekPreview);
+	// Only seeks while dragging if there is no preview yet
+	connect(&playerSeekBar, SIGNAL(scrubbed(int)), &videoPlayer, SLOT(setPosition(int)));
 	connect(&playerSeekBar, SIGNAL(sliderPressed()), &videoPlayer, SLOT(pause()));
-	connect(&playerSeekBar, SIGNAL(sliderReleased()), &videoPlayer, SLOT(resetBreakpointsIterators()));
+	connect(&playerSeekBar, SIGNAL(scrubFinished(int)), &videoPlayer, SLOT(finishScrubbing(int)));
 	playerUILayout->addWidget(&playerSeekBar);
 
 	QWidget* playerTimeViewerWidget = new QWidget;
@@ -158,6 +176,10 @@ void MainWindow::initCentralZone() {
 	connect(this, SIGNAL(projectActivated(bool)), &playerDurationViewer, SLOT(setEnabled(bool)));
 
 	connect(this, SIGNAL(projectActivated(bool)), &videoPlayer, SLOT(activateVideo()));
+	connect(this, SIGNAL(projectActivated(bool)), &presentationPlayer, SLOT(activateVideo()));
+	connect(&videoPlayer, SIGNAL(keyframeIndexLoaded(KeyframeIndex const&)), &presentationPlayer,
+	        SLOT(setKeyframeIndex(KeyframeIndex const&)));
+	connect(this, SIGNAL(projectActivated(bool)), this, SLOT(loadVideoPreviews()));
 	connect(this, SIGNAL(projectActivated(bool)), &videoPlayer, SLOT(setFocus()));
 
 	// }}}
@@ -183,6 +205,18 @@ void MainWindow::initActionWidgets() {
 	connect(openPresentationAction, SIGNAL(triggered()), this, SLOT(openProject()));
 	fileMenu.addAction(openPresentationAction);
 
+	QAction* projectLibraryAction = new QAction(QIcon::fromTheme("folder-open"), "Project &library", this);
+	projectLibraryAction->setShortcut(QKeySequence("Ctrl+L"));
+	connect(projectLibraryAction, SIGNAL(triggered()), this, SLOT(showProjectLibrary()));
+	fileMenu.addAction(projectLibraryAction);
+
+	fileMenu.addSeparator();
+
+	QAction* addVideoClipAction = new QAction(QIcon::fromTheme("list-add"), "Add video &clip", this);
+	addVideoClipAction->setEnabled(false);
+	connect(addVideoClipAction, SIGNAL(triggered()), this, SLOT(addVideoClip()));
+	fileMenu.addAction(addVideoClipAction);
+
 	fileMenu.addSeparator();
 
 	QAction* saveProjectAction =
@@ -230,10 +264,9 @@ void MainWindow::initActionWidgets() {
 	breakpointListView.setEnabled(false);
 	breakpointListView.setSelectionMode(QListView::ExtendedSelection);
 	breakpointListView.setModel(&breakpointListModel);
-
-	connect(&breakpointListModel,
-	        SIGNAL(dataChanged(QModelIndex const&, QModelIndex const&, QVector<int> const&)), this,
-	        SLOT(updateProjectBreakpoints(QModelIndex const&)));
+	breakpointListView.setUniformItemSizes(true);
+	breakpointListView.setIconSize(thumbnailProvider.getThumbnailSize() / 2);
+	breakpointListModel.setThumbnailProvider(&thumbnailProvider);
 
 	QDockWidget* breakpointsDock = new QDockWidget("Breakpoints", this);
 	breakpointsDock->setWidget(&breakpointListView);
@@ -279,11 +312,22 @@ void MainWindow::initActionWidgets() {
 	        SLOT(showAddBreakpointRegularlyDialog()));
 	editMenu.addAction(&addBreakpointRegularly);
 
+	detectSlideChangesAction.setEnabled(false);
+	connect(&detectSlideChangesAction, SIGNAL(triggered()), this,
+	        SLOT(showDetectSlideChangesDialog()));
+	editMenu.addAction(&detectSlideChangesAction);
+
 	removeBreakpointAction.setShortcut(QKeySequence("Ctrl+D"));
 	removeBreakpointAction.setEnabled(false);
 	connect(&removeBreakpointAction, SIGNAL(triggered()), this, SLOT(removeDockBreakpoints()));
 	editMenu.addAction(&removeBreakpointAction);
 
+	editMenu.addSeparator();
+
+	// Breakpoints on keyframes are reached without decoding other frames
+	snapToKeyframesAction.setCheckable(true);
+	editMenu.addAction(&snapToKeyframesAction);
+
 	// }}}
 
 	/*===================*/
@@ -313,6 +357,20 @@ void MainWindow::initActionWidgets() {
 
 	viewMenu.addSeparator();
 
+	// For rehearsals, so it applies to the presentations too
+	QMenu& playbackRateMenu = *viewMenu.addMenu("Playback &speed");
+	QActionGroup* playbackRateGroup = new QActionGroup(this);
+	for(qreal rate : {0.25, 0.5, 0.75, 1.0, 1.25, 1.5, 2.0, 3.0, 4.0}) {
+		QAction* rateAction = new QAction(QString("%1x").arg(rate), playbackRateGroup);
+		rateAction->setCheckable(true);
+		rateAction->setChecked(rate == 1.0);
+		rateAction->setData(rate);
+		playbackRateMenu.addAction(rateAction);
+	}
+	connect(playbackRateGroup, SIGNAL(triggered(QAction*)), this, SLOT(changePlaybackRate(QAction*)));
+
+	viewMenu.addSeparator();
+
 	QAction* jumpToTimeAction =
 	  new QAction(QIcon::fromTheme("go-jump"), "&Jump to specific time", this);
 	jumpToTimeAction->setShortcut(QKeySequence("Ctrl+T"));
@@ -333,12 +391,14 @@ void MainWindow::initActionWidgets() {
 
 	connect(this, SIGNAL(projectActivated(bool)), saveProjectAction, SLOT(setEnabled(bool)));
 	connect(this, SIGNAL(projectActivated(bool)), saveProjectAsAction, SLOT(setEnabled(bool)));
+	connect(this, SIGNAL(projectActivated(bool)), addVideoClipAction, SLOT(setEnabled(bool)));
 
 	connect(this, SIGNAL(projectActivated(bool)), &undoAction, SLOT(setEnabled(bool)));
 	connect(this, SIGNAL(projectActivated(bool)), &redoAction, SLOT(setEnabled(bool)));
 	connect(this, SIGNAL(projectActivated(bool)), &addBreakpointAction, SLOT(setEnabled(bool)));
 	connect(this, SIGNAL(projectActivated(bool)), &addBreakpointHereAction, SLOT(setEnabled(bool)));
 	connect(this, SIGNAL(projectActivated(bool)), &addBreakpointRegularly, SLOT(setEnabled(bool)));
+	connect(this, SIGNAL(projectActivated(bool)), &detectSlideChangesAction, SLOT(setEnabled(bool)));
 	connect(this, SIGNAL(projectActivated(bool)), &removeBreakpointAction, SLOT(setEnabled(bool)));
 
 	connect(this, SIGNAL(projectActivated(bool)), startSlideshowAction, SLOT(setEnabled(bool)));
@@ -357,11 +417,24 @@ ProjectManager const& MainWindow::getProject() const {
 }
 
 void MainWindow::addProjectBreakpoint(qint64 position) {
+	if(snapToKeyframesAction.isChecked()) {
+		position = videoPlayer.getKeyframeIndex().nearestKeyframe(position);
+	}
 	project.addBreakpoint(position);
 }
 
 void MainWindow::addProjectBreakpoints(std::vector<qint64> const& positions) {
-	project.addBreakpoints(positions);
+	if(snapToKeyframesAction.isChecked()) {
+		KeyframeIndex const& keyframeIndex = videoPlayer.getKeyframeIndex();
+		std::vector<qint64> snapped;
+		snapped.reserve(positions.size());
+		for(qint64 position : positions) {
+			snapped.push_back(keyframeIndex.nearestKeyframe(position));
+		}
+		project.addBreakpoints(snapped);
+	} else {
+		project.addBreakpoints(positions);
+	}
 }
 
 VideoPlayerManager const& MainWindow::getVideoPlayer() const {
@@ -400,6 +473,7 @@ void MainWindow::newProject() {
 			project =
 			  ProjectManager(projectFile.toStdString(), videoFileRelativePath.toStdString());
 			history = History(project);
+			autosave.start();
 			emit projectActivated(true);
 			updateDockBreakpoints();
 		}
@@ -410,72 +484,219 @@ void MainWindow::openProject() {
 	QString projectFile = QFileDialog::getOpenFileName(this, "Open project", QDir::homePath(),
 	                                                   "Slideo project file (*.eo)");
 	if(projectFile != "") {
-		project = ProjectManager(projectFile.toStdString());
-		history = History(project);
-		emit projectActivated(true);
-		updateDockBreakpoints();
+		openProjectFile(projectFile);
+	}
+}
+
+void MainWindow::openProjectFile(QString const& projectFile) {
+	// The video is started while the breakpoints are loaded, see projectLoaded
+	try {
+		project.open(projectFile.toStdString());
+	} catch(std::exception const& e) {
+		QMessageBox::critical(this, "Project error",
+		                      "Could not open the project: " + QString::fromLocal8Bit(e.what()));
+		return;
+	}
+	// Restarted once the journal was recovered
+	autosave.stop(false);
+	history = History(project);
+
+	emit projectActivated(true);
+	setBreakpointsEditable(false);
+	updateDockBreakpoints();
+	statusBar()->showMessage("Loading the breakpoints...");
+}
+
+void MainWindow::projectLoaded(bool success, QString const& error) {
+	if(!success) {
+		statusBar()->clearMessage();
+		QMessageBox::critical(this, "Project error",
+		                      "Could not read the breakpoints of the project: " + error);
+		return;
+	}
+	statusBar()->showMessage("Project loaded.", 5000);
+
+	BreakpointsChange recovered;
+	if(Autosave::hasJournal(project.getProjectFile()) &&
+	   QMessageBox::question(this, "Recover modifications",
+	                         "This project was not closed properly. Do you want to recover "
+	                         "the modifications which were not saved?") == QMessageBox::Yes) {
+		recovered = Autosave::readJournal(project.getProjectFile());
+	}
+	autosave.start();
+
+	updateDockBreakpoints();
+	setBreakpointsEditable(true);
+
+	// Applied as a regular change, so it can be undone and is journaled again
+	project.applyChange(recovered);
+}
+
+void MainWindow::setBreakpointsEditable(bool editable) {
+	undoAction.setEnabled(editable);
+	redoAction.setEnabled(editable);
+	addBreakpointAction.setEnabled(editable);
+	addBreakpointHereAction.setEnabled(editable);
+	addBreakpointRegularly.setEnabled(editable);
+	detectSlideChangesAction.setEnabled(editable);
+	removeBreakpointAction.setEnabled(editable);
+}
+
+void MainWindow::showProjectLibrary() {
+	ProjectLibraryDialog dialog(*this);
+	if(dialog.exec() == QDialog::Accepted) {
+		openProjectFile(dialog.getSelectedProject());
+	}
+}
+
+void MainWindow::addVideoClip() {
+	QDir projectDir(QString::fromStdString(project.getProjectFileLocation()));
+	QString videoFile = QFileDialog::getOpenFileName(this, "Select the video file", projectDir.path());
+	if(videoFile == "") {
+		return;
+	}
+
+	// The clips are placed on the timeline from the duration of the previous
+	// ones, as reported by the player
+	Timeline const& playerTimeline = videoPlayer.getTimeline();
+	Timeline projectTimeline = project.getTimeline();
+	for(std::size_t i = 0 ; i < projectTimeline.size() ; ++i) {
+		if(projectTimeline.at(i).duration <= 0 &&
+		   (i >= playerTimeline.size() || playerTimeline.at(i).duration <= 0)) {
+			QMessageBox::warning(this, "Video not loaded",
+			                     "The duration of the video is not known yet, please try again "
+			                     "once it is loaded.");
+			return;
+		}
+	}
+
+	qint64 duration;
+	try {
+		duration = VideoDecoder(videoFile).getDuration();
+	} catch(std::runtime_error const& e) {
+		QMessageBox::critical(this, "Video error",
+		                      "Could not read the video file: " + QString::fromLocal8Bit(e.what()));
+		return;
+	}
+
+	for(std::size_t i = 0 ; i < projectTimeline.size() ; ++i) {
+		if(projectTimeline.at(i).duration <= 0) {
+			project.setClipDuration(i, playerTimeline.at(i).duration);
+		}
 	}
+	project.addClip(projectDir.relativeFilePath(videoFile).toStdString(), duration);
+
+	// Left unsaved like any other modification
+	emit projectActivated(true);
 }
 
 void MainWindow::saveProject() {
+	savingStates.push_back(history.checkpoint());
 	project.saveProject();
-	history.setSaved();
-	statusBar()->showMessage("Project saved.", 5'000);
+}
+
+void MainWindow::projectSaved(bool success, QString const& error) {
+	// The save might not have been started by saveProject
+	bool fromSaveProject = !savingStates.empty();
+	std::size_t state = fromSaveProject ? savingStates.front() : 0;
+	if(fromSaveProject) {
+		savingStates.pop_front();
+	}
+
+	if(success) {
+		if(fromSaveProject) {
+			history.setSaved(state);
+		}
+		statusBar()->showMessage("Project saved.", 5'000);
+	} else {
+		QMessageBox::critical(this, "Save error", "Could not save the project: " + error);
+	}
 	updateWindowTitle();
 }
 
 void MainWindow::startSlideshow() {
-	VideoPlayerManager* fullScreenPlayer =
-	  new VideoPlayerManager(*this, /* position = */ 0, /* presentationMode = */ true);
-	fullScreenPlayer->activateVideo();
+	startPresentation(0);
 }
 
 void MainWindow::startSlideshowFromHere() {
-	VideoPlayerManager* fullScreenPlayer =
-	  new VideoPlayerManager(*this, videoPlayer.getPosition(), /* presentationMode = */ true);
-	fullScreenPlayer->activateVideo();
+	startPresentation(videoPlayer.getPosition());
+}
+
+void MainWindow::changePlaybackRate(QAction* rateAction) {
+	qreal rate = rateAction->data().toReal();
+	videoPlayer.setPlaybackRate(rate);
+	presentationPlayer.setPlaybackRate(rate);
+}
+
+void MainWindow::preparePresentation(QMediaPlayer::State state) {
+	if(state == QMediaPlayer::PausedState) {
+		presentationPlayer.preparePresentation(videoPlayer.getPosition());
+	}
+}
+
+void MainWindow::startPresentation(qint64 position) {
+	QScreen* consoleScreen = windowHandle() ? windowHandle()->screen() : QGuiApplication::primaryScreen();
+	QScreen* presentationScreen = nullptr;
+	for(QScreen* screen : QGuiApplication::screens()) {
+		if(screen != consoleScreen) {
+			presentationScreen = screen;
+			break;
+		}
+	}
+
+	presentationPlayer.startPresentation(position, presentationScreen);
+	if(presentationScreen) {
+		presenterConsole.start(consoleScreen);
+	}
 }
 
 void MainWindow::projectConnections() {
-	connect(&project, SIGNAL(breakpointsChanged()), this, SLOT(updateDockBreakpoints()));
-	connect(&project, SIGNAL(breakpointsChanged()), this, SLOT(updateWindowTitle()));
-	connect(&project, SIGNAL(breakpointsChanged()), this, SLOT(saveState()));
+	// A project might be activated several times
+	breakpointListModel.connectProject();
+	connect(&project, SIGNAL(breakpointsChanged()), this, SLOT(updateWindowTitle()),
+	        Qt::UniqueConnection);
+	connect(&project, SIGNAL(clipsChanged()), this, SLOT(updateWindowTitle()), Qt::UniqueConnection);
+	connect(&project, SIGNAL(breakpointsChanged()), this, SLOT(saveState()), Qt::UniqueConnection);
+	connect(&project, SIGNAL(breakpointsChanged()), &videoPlayer,
+	        SLOT(resetBreakpointsIterators()), Qt::UniqueConnection);
+	connect(&project, SIGNAL(breakpointsChanged()), &presentationPlayer,
+	        SLOT(resetBreakpointsIterators()), Qt::UniqueConnection);
+	connect(&project, SIGNAL(breakpointsLoaded(bool, QString const&)), &videoPlayer,
+	        SLOT(resetBreakpointsIterators()), Qt::UniqueConnection);
+	connect(&project, SIGNAL(breakpointsLoaded(bool, QString const&)), &presentationPlayer,
+	        SLOT(resetBreakpointsIterators()), Qt::UniqueConnection);
+	connect(&project, SIGNAL(projectSaved(bool, QString const&)), this,
+	        SLOT(projectSaved(bool, QString const&)), Qt::UniqueConnection);
+	connect(&project, SIGNAL(breakpointsLoaded(bool, QString const&)), this,
+	        SLOT(projectLoaded(bool, QString const&)), Qt::UniqueConnection);
 }
 
 void MainWindow::updateWindowTitle() {
 	setWindowTitle(project.isSaved() ? "Slideo" : "*Slideo");
 }
 
-void MainWindow::updateProjectBreakpoints(QModelIndex const& index) {
-	auto oldPositionIt = project.getBreakpoints().cbegin();
-	std::advance(oldPositionIt, index.row());
-	qint64 oldPosition = *oldPositionIt,
-	       newPosition = QTime(0, 0, 0, 0).msecsTo(QTime::fromString(
-	         breakpointListModel.data(index, Qt::DisplayRole).toString(), "HH:mm:ss.zzz"));
-	project.replaceBreakpoint(oldPosition, newPosition);
+void MainWindow::updateDockBreakpoints() {
+	breakpointListModel.resetBreakpoints();
 }
 
-void MainWindow::updateDockBreakpoints() {
-	QStringList breakpoints{};
-	for(qint64 const& breakpoint : project.getBreakpoints()) {
-		breakpoints << QTime(0, 0, 0, 0).addMSecs(breakpoint).toString("HH:mm:ss.zzz");
-	}
-	breakpointListModel.setStringList(breakpoints);
+void MainWindow::loadVideoPreviews() {
+	Timeline timeline = project.getTimeline();
+	seekPreview.setTimeline(timeline);
+	thumbnailProvider.setTimeline(timeline);
 }
 
 void MainWindow::saveState() {
-	history.push_back(project);
+	history.push_back(project.getLastChange());
 }
 
 void MainWindow::undo() {
-	project = history.goBack();
-	updateDockBreakpoints();
+	// The dock and the video player are updated through breakpointsChanged
+	history.goBack(project);
 	updateWindowTitle();
 }
 
 void MainWindow::redo() {
-	project = history.advance();
-	updateDockBreakpoints();
+	history.advance(project);
 	updateWindowTitle();
 }
 
@@ -530,22 +751,26 @@ void MainWindow::showAddBreakpointRegularlyDialog() {
 	dialog.exec();
 }
 
+void MainWindow::showDetectSlideChangesDialog() {
+	DetectSlideChangesDialog dialog(*this);
+	dialog.exec();
+}
+
 void MainWindow::showJumpToTimeDialog() {
 	JumpToTimeDialog dialog(*this);
 	dialog.exec();
 }
 
 void MainWindow::addBreakpointHere() {
-	project.addBreakpoint(videoPlayer.getPosition());
+	addProjectBreakpoint(videoPlayer.getPosition());
 }
 
 void MainWindow::removeDockBreakpoints() {
 	QModelIndexList indexes = breakpointListView.selectionModel()->selectedIndexes();
 	std::vector<qint64> positions{};
+	positions.reserve(indexes.size());
 	for(QModelIndex const& index : indexes) {
-		auto positionIt = project.getBreakpoints().cbegin();
-		std::advance(positionIt, index.row());
-		positions.push_back(*positionIt);
+		positions.push_back(project.getBreakpoints().at(index.row()));
 	}
 	project.removeBreakpoints(positions);
 }
@@ -561,6 +786,7 @@ void MainWindow::alternateFullscreen(bool value) {
 void MainWindow::closeEvent(QCloseEvent* event) {
 	if(project.isSaved()) {
 		event->accept();
+		autosave.stop(true);
 	} else {
 		QMessageBox warningMsgBox(this);
 		warningMsgBox.setText("Unsaved modifications");
@@ -573,11 +799,18 @@ void MainWindow::closeEvent(QCloseEvent* event) {
 
 		switch(ret) {
 			case QMessageBox::Save:
-				project.saveProject();
-				event->accept();
+				saveProject();
+				project.waitForSaved();
+				if(project.isSaved()) {
+					event->accept();
+					autosave.stop(true);
+				} else {
+					event->ignore();
+				}
 				break;
 			case QMessageBox::Discard:
 				event->accept();
+				autosave.stop(true);
 				break;
 				// QMessageBox::Cancel
 			default:
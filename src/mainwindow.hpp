@@ -3,18 +3,22 @@
 #include "projectmanager.hpp"
 #include "videoplayermanager.hpp"
 #include "history.hpp"
+#include "autosave.hpp"
 #include "doubleclickablelabel.hpp"
+#include "breakpointlistmodel.hpp"
+#include "seekbar.hpp"
+#include "presenterconsole.hpp"
 
 #include <QMainWindow>
 
 #include <QAction>
 
 #include <QPushButton>
-#include <QSlider>
 #include <QLabel>
 
 #include <QListView>
-#include <QStringListModel>
+
+#include <deque>
 
 /*! \brief Main window of slideo.
  */
@@ -45,12 +49,18 @@ public:
 	ProjectManager const& getProject() const;
 
 	/*! \brief Add a breakpoint to the current project.
+	 *
+	 * The breakpoint is moved to the nearest keyframe if snapping to keyframes
+	 * is enabled.
 	 *
 	 * \param position the position of the breakpoint.
 	 */
 	void addProjectBreakpoint(qint64 position);
 
 	/*! \brief Add several breakpoints to the current project.
+	 *
+	 * The breakpoints are moved to the nearest keyframes if snapping to
+	 * keyframes is enabled.
 	 *
 	 * \param positions the positions of the breakpoints.
 	 */
@@ -78,16 +88,57 @@ public slots:
 
 	/*! \brief Open a project.
 	 *
-	 * This will open a dialog for selecting a project file and load it.
+	 * This will open a dialog for selecting a project file and load it, see
+	 * openProjectFile.
 	 */
 	void openProject();
 
+	/*! \brief Open a given project file.
+	 *
+	 * The video is started right away, the breakpoints are shown and can be
+	 * edited once they are loaded, see projectLoaded.
+	 *
+	 * \param projectFile the path of the project file.
+	 */
+	void openProjectFile(QString const& projectFile);
+
+	/*! \brief Show the projects of a directory, and open the chosen one.
+	 */
+	void showProjectLibrary();
+
+	/*! \brief Handle the end of the loading of the project's breakpoints.
+	 *
+	 * Enables the edition of the breakpoints, after asking the user to
+	 * recover the journal left by a crash, if any.
+	 *
+	 * \param success true if the breakpoints were read.
+	 * \param error the reason of the failure, if any.
+	 */
+	void projectLoaded(bool success, QString const& error);
+
+	/*! \brief Add a video clip at the end of the current project.
+	 *
+	 * This will open a dialog for selecting the video file. The project is
+	 * saved and activated again with the new clip.
+	 */
+	void addVideoClip();
+
 	/*! \brief Save the current project.
 	 *
-	 * Will also show the message "Project saved." for 5 secs on the status bar.
+	 * The project is saved asynchronously, see projectSaved.
 	 */
 	void saveProject();
 
+	/*! \brief Handle the end of a save of the project.
+	 *
+	 * Will show the message "Project saved." for 5 secs on the status bar, or
+	 * the error if the save failed.
+	 *
+	 * \param success true if the project was written.
+	 * \param error the reason of the failure, if any.
+	 */
+	void projectSaved(bool success, QString const& error);
+
 	/*! \brief Start the slideshow in fullscreen mode.
 	 */
 	void startSlideshow();
@@ -96,6 +147,22 @@ public slots:
 	 */
 	void startSlideshowFromHere();
 
+	/*! \brief Change the playback rate of the video and presentation players.
+	 *
+	 * \param rateAction the action of the selected rate, holding the rate as
+	 *        data.
+	 */
+	void changePlaybackRate(QAction* rateAction);
+
+	/*! \brief Seek the hidden presentation player to the current position.
+	 *
+	 * Called when the video player is paused, so "Start slideshow from here"
+	 * shows the right frame instantly.
+	 *
+	 * \param state the state of the video player.
+	 */
+	void preparePresentation(QMediaPlayer::State state);
+
 	/*! \brief Connect project-dependant signals/slots.
 	 *
 	 * This includes the update of the dock when the project's breakpoints are
@@ -111,23 +178,21 @@ public slots:
 	 */
 	void updateWindowTitle();
 
-	/*! \brief Update the breakpoints of the project.
-	 *
-	 * Called when the user change a value directly on the dock of the main window.
+	/*! \brief Reload all the dock breakpoints.
 	 *
-	 * \param index the index of the item modified on the dock list.
+	 * Called when a project is loaded.
 	 */
-	void updateProjectBreakpoints(QModelIndex const& index);
+	void updateDockBreakpoints();
 
-	/*! \brief Update the dock breakpoints.
+	/*! \brief Start generating the seek bar preview and the thumbnails.
 	 *
-	 * Called when the user change a value directly on the dock of the main window.
+	 * Called when a project is loaded or its clips changed.
 	 */
-	void updateDockBreakpoints();
+	void loadVideoPreviews();
 
-	/*! \brief Save the current state in the history.
+	/*! \brief Save the last change of the project in the history.
 	 *
-	 * Will be called when the breakpoints or the video file path changed.
+	 * Will be called when the breakpoints changed.
 	 */
 	void saveState();
 
@@ -195,6 +260,13 @@ public slots:
 	 */
 	void showAddBreakpointRegularlyDialog();
 
+	/*! \brief Show the "Detect slide changes" dialog.
+	 *
+	 * Upon successful completion, it will add a breakpoint at each detected
+	 * slide change.
+	 */
+	void showDetectSlideChangesDialog();
+
 	/*! \brief Show the "Jump to time" dialog.
 	 *
 	 * Upon successful completion, it will jump to the specified time.
@@ -230,24 +302,49 @@ signals:
 protected:
 	void closeEvent(QCloseEvent* event) override;
 
+	/*! \brief Start the presentation player.
+	 *
+	 * With several screens, the presentation is shown on another screen than
+	 * the main window's, and the presenter console on the main window's.
+	 *
+	 * \param position the position to start from.
+	 */
+	void startPresentation(qint64 position);
+
+	/*! \brief Enable or disable the QActions modifying the breakpoints.
+	 *
+	 * \param editable true to enable them.
+	 */
+	void setBreakpointsEditable(bool editable);
+
 	ProjectManager project;
 	VideoPlayerManager videoPlayer;
+	// Kept loaded while hidden, so presentations start instantly
+	VideoPlayerManager presentationPlayer;
 	History history;
+	Autosave autosave;
+	// History states of the saves in progress
+	std::deque<std::size_t> savingStates;
 
 	QAction undoAction;
 	QAction redoAction;
 	QAction addBreakpointAction;
 	QAction addBreakpointHereAction;
 	QAction addBreakpointRegularly;
+	QAction detectSlideChangesAction;
 	QAction removeBreakpointAction;
+	QAction snapToKeyframesAction;
 
 	QPushButton playerPlayPauseButton;
-	QSlider playerSeekBar;
+	SeekBar playerSeekBar;
 
 	DoubleClickableLabel playerPositionViewer;
 	DoubleClickableLabel playerDurationViewer;
 
 	QListView breakpointListView;
-	QStringListModel breakpointListModel;
+	SeekPreview seekPreview;
+	ThumbnailProvider thumbnailProvider;
+	BreakpointListModel breakpointListModel;
+	PresenterConsole presenterConsole;
 private:
 };
@@ -0,0 +1,180 @@
+#include "presenterconsole.hpp"
+
+#include <QHBoxLayout>
+#include <QVBoxLayout>
+
+#include <QKeyEvent>
+#include <QPixmap>
+#include <QTime>
+
+#include <algorithm>
+
+PresenterConsole::PresenterConsole(ProjectManager const& project,
+                                   VideoPlayerManager& presentation,
+                                   BreakpointListModel& breakpointListModel, QWidget* parent)
+      : QWidget(parent, Qt::Window)
+      , project(project)
+      , presentation(presentation)
+      , currentView()
+      , nextFrameView()
+      , nextBreakpointLabel()
+      , segmentElapsedLabel()
+      , segmentRemainingLabel()
+      , presentationElapsedLabel()
+      , breakpointListView() {
+	setWindowTitle("Slideo - Presenter console");
+
+	QHBoxLayout* mainLayout = new QHBoxLayout;
+
+	// Current segment, with the elapsed/remaining times below
+	QVBoxLayout* currentLayout = new QVBoxLayout;
+	currentLayout->addWidget(&currentView, 1);
+
+	QHBoxLayout* timesLayout = new QHBoxLayout;
+	timesLayout->addWidget(&segmentElapsedLabel);
+	timesLayout->addStretch();
+	timesLayout->addWidget(&presentationElapsedLabel);
+	timesLayout->addStretch();
+	timesLayout->addWidget(&segmentRemainingLabel);
+	currentLayout->addLayout(timesLayout);
+
+	mainLayout->addLayout(currentLayout, 3);
+
+	// Next breakpoint and breakpoint list
+	QVBoxLayout* nextLayout = new QVBoxLayout;
+	nextFrameView.setAlignment(Qt::AlignCenter);
+	nextFrameView.setMinimumSize(160, 90);
+	nextFrameView.setStyleSheet("background-color: black;");
+	nextLayout->addWidget(&nextFrameView);
+	nextLayout->addWidget(&nextBreakpointLabel);
+
+	breakpointListView.setModel(&breakpointListModel);
+	breakpointListView.setUniformItemSizes(true);
+	breakpointListView.setEditTriggers(QAbstractItemView::NoEditTriggers);
+	breakpointListView.setFocusPolicy(Qt::NoFocus);
+	nextLayout->addWidget(&breakpointListView, 1);
+
+	mainLayout->addLayout(nextLayout, 1);
+
+	setLayout(mainLayout);
+
+	QFont timeFont = segmentElapsedLabel.font();
+	timeFont.setPointSize(timeFont.pointSize() * 2);
+	segmentElapsedLabel.setFont(timeFont);
+	segmentRemainingLabel.setFont(timeFont);
+	presentationElapsedLabel.setFont(timeFont);
+
+	if(!presentation.addPresenterView(currentView)) {
+		currentView.hide();
+	}
+
+	updateTimer.setInterval(200);
+	connect(&updateTimer, SIGNAL(timeout()), this, SLOT(refresh()));
+	connect(&breakpointListView, SIGNAL(doubleClicked(QModelIndex const&)), this,
+	        SLOT(jumpToBreakpoint(QModelIndex const&)));
+	connect(&presentation, SIGNAL(presentationFinished()), this, SLOT(finish()));
+}
+
+PresenterConsole::~PresenterConsole() {
+	presentation.removePresenterView(currentView);
+}
+
+void PresenterConsole::start(QScreen* screen) {
+	nextFrameBreakpoint = -1;
+	presentationClock.start();
+
+	setGeometry(screen->geometry());
+	setWindowState(Qt::WindowFullScreen);
+	show();
+
+	refresh();
+	updateTimer.start();
+}
+
+void PresenterConsole::finish() {
+	updateTimer.stop();
+	hide();
+}
+
+void PresenterConsole::refresh() {
+	BreakpointSet const& breakpoints = project.getBreakpoints();
+	qint64 position = presentation.getPosition();
+
+	// The current segment is between the last breakpoint reached and the next,
+	// the position might be slightly before the breakpoint the player paused on
+	std::size_t next = breakpoints.upperBound(position + presentation.getBreakpointTolerance());
+	qint64 segmentStart = (next > 0) ? breakpoints.at(next - 1) : 0;
+	qint64 segmentEnd = (next < breakpoints.size()) ? breakpoints.at(next) : presentation.getDuration();
+
+	segmentElapsedLabel.setText(formatDuration(position - segmentStart));
+	segmentRemainingLabel.setText("-" + formatDuration(std::max<qint64>(segmentEnd - position, 0)));
+	presentationElapsedLabel.setText(formatDuration(presentationClock.elapsed()));
+
+	if(next < breakpoints.size()) {
+		nextBreakpointLabel.setText("Next: " + BreakpointListModel::format(segmentEnd));
+	} else {
+		nextBreakpointLabel.setText("Last segment");
+	}
+
+	// Decoded ahead by the presentation, may not be ready yet
+	if(next < breakpoints.size() && segmentEnd != nextFrameBreakpoint) {
+		QImage frame = presentation.getBreakpointFrame(segmentEnd);
+		if(!frame.isNull()) {
+			nextFrameView.setPixmap(QPixmap::fromImage(frame).scaled(
+			  nextFrameView.size(), Qt::KeepAspectRatio, Qt::SmoothTransformation));
+			nextFrameBreakpoint = segmentEnd;
+		} else {
+			nextFrameView.clear();
+		}
+	} else if(next >= breakpoints.size()) {
+		nextFrameView.clear();
+		nextFrameBreakpoint = -1;
+	}
+
+	if(next > 0) {
+		// The model populates its rows progressively
+		QAbstractItemModel* model = breakpointListView.model();
+		while(static_cast<int>(next) > model->rowCount() && model->canFetchMore(QModelIndex())) {
+			model->fetchMore(QModelIndex());
+		}
+		QModelIndex current = model->index(next - 1, 0);
+		if(breakpointListView.currentIndex() != current) {
+			breakpointListView.setCurrentIndex(current);
+			breakpointListView.scrollTo(current);
+		}
+	}
+}
+
+void PresenterConsole::jumpToBreakpoint(QModelIndex const& index) {
+	BreakpointSet const& breakpoints = project.getBreakpoints();
+	if(index.isValid() && index.row() < static_cast<int>(breakpoints.size())) {
+		presentation.pause();
+		presentation.setPosition(breakpoints.at(index.row()));
+	}
+}
+
+void PresenterConsole::keyPressEvent(QKeyEvent* event) {
+	switch(event->key()) {
+		case Qt::Key_Space:
+			presentation.playPause();
+			break;
+		case Qt::Key_Right:
+		case Qt::Key_PageDown:
+			presentation.jumpToNextBreakpoint();
+			break;
+		case Qt::Key_Left:
+		case Qt::Key_PageUp:
+			presentation.jumpToPreviousBreakpoint();
+			break;
+		case Qt::Key_Escape:
+			presentation.close();
+			break;
+		default:
+			QWidget::keyPressEvent(event);
+			break;
+	}
+}
+
+QString PresenterConsole::formatDuration(qint64 duration) {
+	return QTime(0, 0, 0, 0).addMSecs(duration).toString("HH:mm:ss");
+}
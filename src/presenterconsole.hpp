@@ -0,0 +1,95 @@
+#pragma once
+
+#include "projectmanager.hpp"
+#include "videoplayermanager.hpp"
+#include "breakpointlistmodel.hpp"
+
+#include <QWidget>
+
+#include <QElapsedTimer>
+#include <QLabel>
+#include <QListView>
+#include <QTimer>
+#include <QVideoWidget>
+
+/*! \brief Presenter console, shown on another screen during presentations.
+ *
+ * Shows the current segment (the same frames as the presentation), the
+ * frame of the next breakpoint, the elapsed/remaining time of the segment
+ * and the list of the breakpoints.
+ *
+ * The keys are forwarded to the presentation.
+ */
+class PresenterConsole : public QWidget {
+
+	Q_OBJECT
+
+public:
+	/*! \brief PresenterConsole constructor.
+	 *
+	 * \param project the presented project.
+	 * \param presentation the presentation player.
+	 * \param breakpointListModel the model of the breakpoints, shared with the
+	 *        main window.
+	 * \param parent the parent widget (the main window).
+	 */
+	PresenterConsole(ProjectManager const& project, VideoPlayerManager& presentation,
+	                 BreakpointListModel& breakpointListModel, QWidget* parent = nullptr);
+
+	/*! \brief PresenterConsole destructor.
+	 *
+	 * Stops showing the presentation in the current view.
+	 */
+	~PresenterConsole();
+
+public slots:
+	/*! \brief Show the console fullscreen.
+	 *
+	 * \param screen the screen to show the console on.
+	 */
+	void start(QScreen* screen);
+
+	/*! \brief Hide the console.
+	 */
+	void finish();
+
+	/*! \brief Update the next frame, the times and the current breakpoint.
+	 *
+	 * Called regularly while the console is shown.
+	 */
+	void refresh();
+
+	/*! \brief Jump the presentation to the double-clicked breakpoint.
+	 *
+	 * \param index the index of the breakpoint.
+	 */
+	void jumpToBreakpoint(QModelIndex const& index);
+
+protected:
+	/*! \brief Forward the keys to the presentation.
+	 *
+	 * \param event the event containing the pressed key.
+	 */
+	virtual void keyPressEvent(QKeyEvent* event) override;
+
+	/*! \brief Format a duration as "HH:mm:ss".
+	 *
+	 * \param duration the duration in msecs.
+	 */
+	static QString formatDuration(qint64 duration);
+
+	ProjectManager const& project;
+	VideoPlayerManager& presentation;
+
+	QVideoWidget currentView;
+	QLabel nextFrameView;
+	QLabel nextBreakpointLabel;
+	QLabel segmentElapsedLabel;
+	QLabel segmentRemainingLabel;
+	QLabel presentationElapsedLabel;
+	QListView breakpointListView;
+
+	QTimer updateTimer;
+	QElapsedTimer presentationClock;
+	qint64 nextFrameBreakpoint = -1;
+};
@@ -0,0 +1,360 @@
+#include "projectlibrary.hpp"
+
+#include "breakpointsfile.hpp"
+#include "timelinedecoder.hpp"
+
+#include <QDataStream>
+#include <QDateTime>
+#include <QDir>
+#include <QDirIterator>
+#include <QFile>
+#include <QFileInfo>
+#include <QHash>
+#include <QMap>
+#include <QSaveFile>
+#include <QStandardPaths>
+
+#include <QtConcurrent>
+
+#include <yaml-cpp/eventhandler.h>
+#include <yaml-cpp/parser.h>
+
+#include <exception>
+#include <fstream>
+#include <stdexcept>
+
+namespace {
+	quint32 const magic = 0x534c444c; // "SLDL"
+	quint32 const version = 1;
+
+	/* Reads the header of a project from the parser events, so the
+	 * breakpoints are counted without building a node for each of them.
+	 */
+	class HeaderReader : public YAML::EventHandler {
+	public:
+		explicit HeaderReader(QDir const& baseDirectory)
+		      : baseDirectory(baseDirectory) {}
+
+		QString videoFile, breakpointsFile;
+		quint64 breakpointCount = 0;
+		Timeline timeline;
+
+		void OnDocumentStart(YAML::Mark const&) override {}
+		void OnDocumentEnd() override {}
+
+		void OnNull(YAML::Mark const&, YAML::anchor_t) override {
+			value(std::string());
+		}
+
+		void OnAlias(YAML::Mark const&, YAML::anchor_t) override {
+			value(std::string());
+		}
+
+		void OnScalar(YAML::Mark const&, std::string const&, YAML::anchor_t,
+		              std::string const& scalar) override {
+			value(scalar);
+		}
+
+		void OnSequenceStart(YAML::Mark const&, std::string const&, YAML::anchor_t,
+		                     YAML::EmitterStyle::value) override {
+			levels.push_back(Level{false});
+		}
+
+		void OnSequenceEnd() override {
+			leave();
+		}
+
+		void OnMapStart(YAML::Mark const&, std::string const&, YAML::anchor_t,
+		                YAML::EmitterStyle::value) override {
+			if(inClips(2)) {
+				clipFile.clear();
+				clipDuration = 0;
+			}
+			levels.push_back(Level{true});
+		}
+
+		void OnMapEnd() override {
+			if(inClips(3)) {
+				timeline.append(baseDirectory.filePath(clipFile), clipDuration);
+			}
+			leave();
+		}
+
+	private:
+		struct Level {
+			bool map;
+			bool expectingKey = true;
+			// Key of the value being read, for maps
+			std::string key;
+		};
+
+		bool inClips(std::size_t depth) const {
+			return levels.size() == depth && levels[0].key == "clips";
+		}
+
+		void value(std::string const& scalar) {
+			if(!levels.empty() && levels.back().map && levels.back().expectingKey) {
+				levels.back().key = scalar;
+				levels.back().expectingKey = false;
+				return;
+			}
+
+			QString text = QString::fromStdString(scalar);
+			if(levels.size() == 1 && levels[0].key == "video-file") {
+				videoFile = text;
+				timeline.append(baseDirectory.filePath(text), 0);
+			} else if(levels.size() == 1 && levels[0].key == "breakpoints-file") {
+				breakpointsFile = text;
+			} else if(levels.size() == 2 && levels[0].key == "breakpoints") {
+				++breakpointCount;
+			} else if(inClips(3) && levels[2].key == "file") {
+				clipFile = text;
+				if(videoFile.isEmpty()) {
+					videoFile = text;
+				}
+			} else if(inClips(3) && levels[2].key == "duration") {
+				clipDuration = text.toLongLong();
+			}
+			nextKey();
+		}
+
+		void leave() {
+			levels.pop_back();
+			nextKey();
+		}
+
+		void nextKey() {
+			if(!levels.empty() && levels.back().map) {
+				levels.back().expectingKey = true;
+			}
+		}
+
+		QDir baseDirectory;
+		std::vector<Level> levels;
+		QString clipFile;
+		qint64 clipDuration = 0;
+	};
+
+	// Function object so QtConcurrent can deduce the result type
+	struct EntryReader {
+		using result_type = ProjectLibrary::Entry;
+
+		QHash<QString, ProjectLibrary::Entry> cached;
+
+		result_type operator()(QString const& projectFile) const {
+			QFileInfo info(projectFile);
+			auto entry = cached.constFind(projectFile);
+			if(entry != cached.constEnd() && entry->projectSize == info.size() &&
+			   entry->projectModified == info.lastModified().toMSecsSinceEpoch()) {
+				return *entry;
+			}
+			return ProjectLibrary::readEntry(projectFile);
+		}
+	};
+
+	QDataStream& operator<<(QDataStream& out, ProjectLibrary::Entry const& entry) {
+		return out << entry.projectFile << entry.videoFile << static_cast<qint32>(entry.clipCount)
+		           << entry.breakpointCount << entry.duration << entry.projectSize
+		           << entry.projectModified << entry.error;
+	}
+
+	QDataStream& operator>>(QDataStream& in, ProjectLibrary::Entry& entry) {
+		qint32 clipCount;
+		in >> entry.projectFile >> entry.videoFile >> clipCount >> entry.breakpointCount >>
+		  entry.duration >> entry.projectSize >> entry.projectModified >> entry.error;
+		entry.clipCount = clipCount;
+		return in;
+	}
+}
+
+ProjectLibrary::ProjectLibrary(QObject* parent)
+      : QObject(parent)
+      , directory()
+      , entries()
+      , listWatcher()
+      , readWatcher() {
+	loadIndex();
+
+	connect(&listWatcher, SIGNAL(finished()), this, SLOT(readProjects()));
+	connect(&readWatcher, SIGNAL(finished()), this, SLOT(storeEntries()));
+}
+
+ProjectLibrary::~ProjectLibrary() {
+	// The listing cannot be cancelled, but its result is not read anymore
+	listWatcher.waitForFinished();
+
+	bool interrupted = readWatcher.isRunning();
+	readWatcher.cancel();
+	readWatcher.waitForFinished();
+	if(!interrupted) {
+		return;
+	}
+
+	// The projects not read yet keep their cached entry
+	QMap<QString, Entry> merged;
+	for(Entry const& entry : entries) {
+		merged.insert(entry.projectFile, entry);
+	}
+	for(Entry const& entry : readWatcher.future().results()) {
+		merged.insert(entry.projectFile, entry);
+	}
+	entries.assign(merged.cbegin(), merged.cend());
+	saveIndex();
+}
+
+QString ProjectLibrary::getDirectory() const {
+	return directory;
+}
+
+std::vector<ProjectLibrary::Entry> const& ProjectLibrary::getEntries() const {
+	return entries;
+}
+
+bool ProjectLibrary::isScanning() const {
+	return listWatcher.isRunning() || readWatcher.isRunning();
+}
+
+void ProjectLibrary::scan(QString const& directory) {
+	if(directory != this->directory) {
+		this->directory = directory;
+		entries.clear();
+		emit entriesChanged();
+	}
+
+	// The workers do not use the library, so a previous scan can simply be
+	// forgotten, along with its results
+	readWatcher.cancel();
+	readWatcher.setFuture(QFuture<Entry>());
+	listWatcher.setFuture(QtConcurrent::run([directory]() {
+		QStringList projectFiles;
+		QDirIterator it(directory, QStringList{"*.eo"}, QDir::Files,
+		                QDirIterator::Subdirectories | QDirIterator::FollowSymlinks);
+		while(it.hasNext()) {
+			projectFiles.append(it.next());
+		}
+		projectFiles.sort();
+		return projectFiles;
+	}));
+}
+
+ProjectLibrary::Entry ProjectLibrary::readEntry(QString const& projectFile) {
+	QFileInfo info(projectFile);
+
+	Entry entry;
+	entry.projectFile = projectFile;
+	entry.projectSize = info.size();
+	entry.projectModified = info.lastModified().toMSecsSinceEpoch();
+
+	try {
+		std::ifstream input(QFile::encodeName(projectFile).constData());
+		if(!input) {
+			throw std::runtime_error("Could not open " + projectFile.toStdString());
+		}
+
+		HeaderReader header(info.absoluteDir());
+		YAML::Parser parser(input);
+		parser.HandleNextDocument(header);
+
+		entry.videoFile = header.videoFile;
+		entry.clipCount = static_cast<int>(header.timeline.size());
+		entry.breakpointCount = header.breakpointCount;
+		if(!header.breakpointsFile.isEmpty()) {
+			entry.breakpointCount =
+			  BreakpointsFile::readCount(info.absoluteDir().filePath(header.breakpointsFile));
+		}
+
+		Timeline timeline = header.timeline;
+		bool durationKnown = true;
+		for(std::size_t i = 0 ; i < timeline.size() ; ++i) {
+			durationKnown = durationKnown && timeline.at(i).duration > 0;
+		}
+		if(!durationKnown) {
+			// Only the older projects, which had a single video
+			timeline = TimelineDecoder(timeline).getTimeline();
+		}
+		entry.duration = timeline.getDuration();
+	} catch(std::exception const& e) {
+		entry.error = QString::fromLocal8Bit(e.what());
+	}
+
+	return entry;
+}
+
+QString ProjectLibrary::indexFile() {
+	return QDir(QStandardPaths::writableLocation(QStandardPaths::CacheLocation))
+	  .filePath("library.index");
+}
+
+void ProjectLibrary::readProjects() {
+	EntryReader reader;
+	for(Entry const& entry : entries) {
+		reader.cached.insert(entry.projectFile, entry);
+	}
+
+	readWatcher.setFuture(QtConcurrent::mapped(listWatcher.result(), reader));
+}
+
+void ProjectLibrary::storeEntries() {
+	if(readWatcher.isCanceled()) {
+		return;
+	}
+
+	QList<Entry> results = readWatcher.future().results();
+	entries.assign(results.begin(), results.end());
+	emit entriesChanged();
+
+	saveIndex();
+	emit scanFinished();
+}
+
+void ProjectLibrary::loadIndex() {
+	QFile file(indexFile());
+	if(!file.open(QIODevice::ReadOnly)) {
+		return;
+	}
+
+	QDataStream in(&file);
+	in.setVersion(QDataStream::Qt_5_0);
+
+	quint32 fileMagic, fileVersion;
+	in >> fileMagic >> fileVersion;
+	if(fileMagic != magic || fileVersion != version) {
+		return;
+	}
+
+	QString directory;
+	quint32 count;
+	in >> directory >> count;
+
+	std::vector<Entry> entries;
+	for(quint32 i = 0 ; i < count && in.status() == QDataStream::Ok ; ++i) {
+		Entry entry;
+		in >> entry;
+		entries.push_back(entry);
+	}
+
+	if(in.status() == QDataStream::Ok) {
+		this->directory = directory;
+		this->entries = std::move(entries);
+	}
+}
+
+void ProjectLibrary::saveIndex() const {
+	QDir().mkpath(QFileInfo(indexFile()).absolutePath());
+
+	QSaveFile file(indexFile());
+	if(!file.open(QIODevice::WriteOnly)) {
+		return;
+	}
+
+	QDataStream out(&file);
+	out.setVersion(QDataStream::Qt_5_0);
+
+	out << magic << version << directory << static_cast<quint32>(entries.size());
+	for(Entry const& entry : entries) {
+		out << entry;
+	}
+
+	// Scanned again next time if it fails
+	file.commit();
+}
@@ -0,0 +1,131 @@
+#pragma once
+
+#include <QObject>
+#include <QFutureWatcher>
+#include <QString>
+#include <QStringList>
+
+#include <vector>
+
+/*! \brief Library of the projects of a directory tree.
+ *
+ * The project files are read on the thread pool, but only their header: the
+ * clips and the number of breakpoints, the breakpoints themselves are never
+ * loaded.
+ *
+ * The entries are cached in an index file, so the library of the last
+ * scanned directory is shown instantly and only the modified projects are
+ * read again.
+ */
+class ProjectLibrary : public QObject {
+
+	Q_OBJECT
+
+public:
+	/*! \brief Summary of a project file.
+	 */
+	struct Entry {
+		QString projectFile;
+		// The first clip, as written in the project
+		QString videoFile;
+		int clipCount = 0;
+		quint64 breakpointCount = 0;
+		// 0 if unknown
+		qint64 duration = 0;
+
+		// To tell if the cached entry is outdated
+		qint64 projectSize = 0;
+		qint64 projectModified = 0;
+
+		// Empty if the project could be read
+		QString error;
+	};
+
+	/*! \brief ProjectLibrary constructor.
+	 *
+	 * Loads the entries of the last scanned directory from the index file.
+	 *
+	 * \param parent the parent object.
+	 */
+	explicit ProjectLibrary(QObject* parent = nullptr);
+
+	/*! \brief ProjectLibrary destructor.
+	 *
+	 * Cancels the scan and waits for the workers. The projects read so far
+	 * are saved in the index, so the next scan only reads the others.
+	 */
+	~ProjectLibrary();
+
+	/*! \brief Get the scanned directory.
+	 *
+	 * \return the directory, empty if none was ever scanned.
+	 */
+	QString getDirectory() const;
+
+	/*! \brief Get the projects of the scanned directory.
+	 *
+	 * \return the entries, sorted by project file.
+	 */
+	std::vector<Entry> const& getEntries() const;
+
+	/*! \brief Returns true if a scan is running.
+	 */
+	bool isScanning() const;
+
+	/*! \brief Scan a directory tree for project files.
+	 *
+	 * The cached entries of the directory are available right away, the
+	 * scan runs in the background and emits entriesChanged and scanFinished
+	 * when done. A previous scan is forgotten.
+	 *
+	 * \param directory the directory to scan.
+	 */
+	void scan(QString const& directory);
+
+	/*! \brief Read the summary of a project file.
+	 *
+	 * Errors are stored in the entry instead of being thrown. The videos are
+	 * only opened if the project does not know the duration of its clips.
+	 *
+	 * \param projectFile the path of the project file.
+	 * \return the summary.
+	 */
+	static Entry readEntry(QString const& projectFile);
+
+	/*! \brief Get the path of the index file.
+	 */
+	static QString indexFile();
+
+signals:
+	/*! \brief Emitted when the entries were replaced.
+	 */
+	void entriesChanged();
+
+	/*! \brief Emitted when a scan is finished.
+	 */
+	void scanFinished();
+
+protected slots:
+	/*! \brief Read the project files found by the scan.
+	 */
+	void readProjects();
+
+	/*! \brief Store the entries read by the scan and save the index.
+	 */
+	void storeEntries();
+
+protected:
+	/*! \brief Load the index file, ignoring errors.
+	 */
+	void loadIndex();
+
+	/*! \brief Save the index file, ignoring errors.
+	 */
+	void saveIndex() const;
+
+	QString directory;
+	std::vector<Entry> entries;
+
+	QFutureWatcher<QStringList> listWatcher;
+	QFutureWatcher<Entry> readWatcher;
+};
@@ -0,0 +1,131 @@
+#include "projectlibrarydialog.hpp"
+
+#include <QVBoxLayout>
+#include <QHBoxLayout>
+
+#include <QDir>
+#include <QFileDialog>
+#include <QFileInfo>
+#include <QHeaderView>
+#include <QTime>
+
+ProjectLibraryDialog::ProjectLibraryDialog(QWidget& parent)
+      : QDialog(&parent)
+      , parent(parent)
+      , library()
+      , directoryLabel()
+      , statusLabel()
+      , directoryButton("Change directory...")
+      , projectList()
+      , cancelButton("Cancel")
+      , validateButton("Open")
+      , selectedProject() {
+	QVBoxLayout* mainLayout = new QVBoxLayout;
+
+	QHBoxLayout* directoryLayout = new QHBoxLayout;
+	directoryLayout->addWidget(&directoryLabel, 1);
+	directoryLayout->addWidget(&directoryButton);
+
+	QWidget* directoryWidget = new QWidget;
+	directoryWidget->setLayout(directoryLayout);
+
+	projectList.setHeaderLabels({"Project", "Video", "Clips", "Breakpoints", "Duration"});
+	projectList.setRootIsDecorated(false);
+	projectList.setSortingEnabled(true);
+	projectList.header()->setSectionResizeMode(0, QHeaderView::Stretch);
+
+	QHBoxLayout* buttonsLayout = new QHBoxLayout;
+	buttonsLayout->addWidget(&statusLabel, 1);
+	buttonsLayout->addWidget(&cancelButton);
+	buttonsLayout->addWidget(&validateButton);
+
+	validateButton.setDefault(true);
+
+	QWidget* buttonsWidget = new QWidget;
+	buttonsWidget->setLayout(buttonsLayout);
+
+	mainLayout->addWidget(directoryWidget);
+	mainLayout->addWidget(&projectList);
+	mainLayout->addWidget(buttonsWidget);
+
+	setLayout(mainLayout);
+	setWindowTitle("Project library");
+	resize(720, 480);
+
+	connect(&library, SIGNAL(entriesChanged()), this, SLOT(updateEntries()));
+	connect(&library, SIGNAL(scanFinished()), this, SLOT(scanFinished()));
+	connect(&directoryButton, SIGNAL(clicked()), this, SLOT(chooseDirectory()));
+	connect(&projectList, SIGNAL(itemActivated(QTreeWidgetItem*, int)), this, SLOT(validate()));
+	connect(&cancelButton, SIGNAL(clicked()), this, SLOT(cancel()));
+	connect(&validateButton, SIGNAL(clicked()), this, SLOT(validate()));
+
+	// Shows the index right away, the scan updates it
+	updateEntries();
+	if(library.getDirectory().isEmpty()) {
+		statusLabel.setText("Choose the directory containing your projects.");
+	} else {
+		library.scan(library.getDirectory());
+		statusLabel.setText("Scanning...");
+	}
+}
+
+QString ProjectLibraryDialog::getSelectedProject() const {
+	return selectedProject;
+}
+
+void ProjectLibraryDialog::chooseDirectory() {
+	QString directory = QFileDialog::getExistingDirectory(
+	  this, "Select the directory of the projects",
+	  library.getDirectory().isEmpty() ? QDir::homePath() : library.getDirectory());
+	if(directory != "") {
+		library.scan(directory);
+		statusLabel.setText("Scanning...");
+	}
+}
+
+void ProjectLibraryDialog::updateEntries() {
+	QDir directory(library.getDirectory());
+	directoryLabel.setText(library.getDirectory());
+
+	projectList.setSortingEnabled(false);
+	projectList.clear();
+	for(ProjectLibrary::Entry const& entry : library.getEntries()) {
+		QTreeWidgetItem* item = new QTreeWidgetItem(&projectList);
+		item->setText(0, directory.relativeFilePath(entry.projectFile));
+		item->setData(0, Qt::UserRole, entry.projectFile);
+
+		if(!entry.error.isEmpty()) {
+			item->setText(1, entry.error);
+			item->setToolTip(1, entry.error);
+			item->setForeground(1, palette().brush(QPalette::Disabled, QPalette::Text));
+			continue;
+		}
+
+		item->setText(1, QFileInfo(entry.videoFile).fileName());
+		item->setToolTip(1, entry.videoFile);
+		item->setData(2, Qt::DisplayRole, entry.clipCount);
+		item->setData(3, Qt::DisplayRole, entry.breakpointCount);
+		if(entry.duration > 0) {
+			item->setText(4, QTime(0, 0, 0, 0).addMSecs(entry.duration).toString("HH:mm:ss"));
+		}
+	}
+	projectList.setSortingEnabled(true);
+}
+
+void ProjectLibraryDialog::scanFinished() {
+	statusLabel.setText(QString::number(library.getEntries().size()) + " projects");
+}
+
+void ProjectLibraryDialog::cancel() {
+	done(QDialog::Rejected);
+}
+
+void ProjectLibraryDialog::validate() {
+	QTreeWidgetItem* item = projectList.currentItem();
+	if(item == nullptr) {
+		return;
+	}
+
+	selectedProject = item->data(0, Qt::UserRole).toString();
+	done(QDialog::Accepted);
+}
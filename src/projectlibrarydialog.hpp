@@ -0,0 +1,67 @@
+#pragma once
+
+#include "projectlibrary.hpp"
+
+#include <QDialog>
+#include <QLabel>
+#include <QPushButton>
+#include <QTreeWidget>
+
+/*! \brief Dialog listing the projects of a directory tree.
+ *
+ * The projects of the last scanned directory are shown from the library's
+ * index, and updated when the directory has been scanned again.
+ */
+class ProjectLibraryDialog : public QDialog {
+
+	Q_OBJECT
+
+public:
+	/*! \brief ProjectLibraryDialog constructor.
+	 *
+	 * \param parent the parent widget (the main window).
+	 */
+	ProjectLibraryDialog(QWidget& parent);
+
+	/*! \brief Get the project chosen by the user.
+	 *
+	 * \return the path of the project file, empty if none was chosen.
+	 */
+	QString getSelectedProject() const;
+
+public slots:
+
+	/*! \brief Function called when the user wants to scan another directory.
+	 */
+	virtual void chooseDirectory();
+
+	/*! \brief Fill the list with the entries of the library.
+	 */
+	virtual void updateEntries();
+
+	/*! \brief Show that the scan is finished.
+	 */
+	virtual void scanFinished();
+
+	/*! \brief Function called when the user cancels.
+	 */
+	virtual void cancel();
+
+	/*! \brief Function called when the user validates.
+	 *
+	 * The selected project can then be retrieved with getSelectedProject.
+	 */
+	virtual void validate();
+
+protected:
+	QWidget& parent;
+
+	ProjectLibrary library;
+
+	QLabel directoryLabel, statusLabel;
+	QPushButton directoryButton;
+	QTreeWidget projectList;
+	QPushButton cancelButton, validateButton;
+
+	QString selectedProject;
+};
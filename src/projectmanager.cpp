@@ -1,14 +1,22 @@
 #include "projectmanager.hpp"
 
+#include "breakpointsfile.hpp"
+
+#include <QDir>
+#include <QFile>
 #include <QFileInfo>
+#include <QSaveFile>
+
+#include <QtConcurrent>
 
-#include <fstream>
+#include <algorithm>
+#include <stdexcept>
 
-// Conversion of std::set<qint64> to/from YAML::Node
+// Conversion of BreakpointSet to/from YAML::Node
 namespace YAML {
 	template<>
-	struct convert<std::set<qint64>> {
-		static Node encode(const std::set<qint64>& rhs) {
+	struct convert<BreakpointSet> {
+		static Node encode(const BreakpointSet& rhs) {
 			Node node;
 			if(rhs.empty()) {
 				node = YAML::Load("[]");
@@ -20,35 +28,68 @@ namespace YAML {
 			return node;
 		}
 
-		static bool decode(const Node& node, std::set<qint64>& rhs) {
+		static bool decode(const Node& node, BreakpointSet& rhs) {
 			if(!node.IsSequence()) {
 				return false;
 			}
-			std::size_t size = node.size();
-			for(std::size_t i = 0 ; i < size ; ++i) {
-				rhs.insert(node[i].as<qint64>());
+			std::vector<qint64> values;
+			values.reserve(node.size());
+			for(Node const& value : node) {
+				values.push_back(value.as<qint64>());
 			}
+			rhs = BreakpointSet(std::move(values));
 			return true;
 		}
 	};
 }
 
+namespace {
+	// Number of values lower than value in a sorted vector
+	std::size_t countLess(std::vector<qint64> const& values, qint64 value) {
+		return std::lower_bound(values.cbegin(), values.cend(), value) - values.cbegin();
+	}
+}
+
+ProjectManager::ProjectManager()
+      : QObject() {
+	connect(&saveWatcher, SIGNAL(finished()), this, SLOT(finishSave()));
+	connect(&loadWatcher, SIGNAL(finished()), this, SLOT(finishLoad()));
+}
+
+ProjectManager::~ProjectManager() {
+	// The receivers might be destroyed already
+	blockSignals(true);
+	waitForSaved();
+	waitForLoaded();
+}
+
 ProjectManager::ProjectManager(std::string projectFile)
       : QObject()
-      , projectFile(projectFile)
-      , project(YAML::LoadFile(projectFile))
-      , breakpoints(project["breakpoints"].as<std::set<qint64>>()) {}
+      , projectFile()
+      , project()
+      , breakpoints() {
+	connect(&saveWatcher, SIGNAL(finished()), this, SLOT(finishSave()));
+	connect(&loadWatcher, SIGNAL(finished()), this, SLOT(finishLoad()));
+
+	open(projectFile);
+	waitForLoaded();
+	if(!loadError.isEmpty()) {
+		throw std::runtime_error(loadError.toStdString());
+	}
+}
 
 ProjectManager::ProjectManager(std::string projectFile, std::string videoFile)
       : QObject()
       , projectFile(projectFile)
       , project()
       , breakpoints() {
+	connect(&saveWatcher, SIGNAL(finished()), this, SLOT(finishSave()));
+	connect(&loadWatcher, SIGNAL(finished()), this, SLOT(finishLoad()));
 
-	project["breakpoints"] = YAML::Load("[]");
 	project["video-file"] = videoFile;
 
 	saveProject();
+	waitForSaved();
 }
 
 ProjectManager::ProjectManager(ProjectManager const& other)
@@ -56,20 +97,31 @@ ProjectManager::ProjectManager(ProjectManager const& other)
       , projectFile(other.getProjectFile())
       , saved(other.isSaved())
       , project(other.getProjectNode())
-      , breakpoints(other.getBreakpoints()) {}
+      , breakpointsFormat(other.getBreakpointsFormat())
+      , breakpoints(other.getBreakpoints()) {
+	connect(&saveWatcher, SIGNAL(finished()), this, SLOT(finishSave()));
+	connect(&loadWatcher, SIGNAL(finished()), this, SLOT(finishLoad()));
+}
 
 ProjectManager::ProjectManager(ProjectManager&& other) noexcept
       : QObject()
-      , projectFile(std::move(other.getProjectFile()))
-      , saved(std::move(other.isSaved()))
-      , project(std::move(other.getProjectNode()))
-      , breakpoints(std::move(other.getBreakpoints())) {}
+      , projectFile(std::move(other.projectFile))
+      , saved(other.saved)
+      , project(std::move(other.project))
+      , breakpointsFormat(other.breakpointsFormat)
+      , breakpoints(std::move(other.breakpoints)) {
+	connect(&saveWatcher, SIGNAL(finished()), this, SLOT(finishSave()));
+	connect(&loadWatcher, SIGNAL(finished()), this, SLOT(finishLoad()));
+}
 
 ProjectManager& ProjectManager::operator=(ProjectManager const& other) noexcept {
 	if(&other != this) {
+		waitForSaved();
+		waitForLoaded();
 		projectFile = std::string(other.getProjectFile());
 		saved = other.isSaved();
 		project = other.getProjectNode();
+		breakpointsFormat = other.getBreakpointsFormat();
 		breakpoints = other.getBreakpoints();
 	}
 	return *this;
@@ -77,14 +129,75 @@ ProjectManager& ProjectManager::operator=(ProjectManager const& other) noexcept
 
 ProjectManager& ProjectManager::operator=(ProjectManager&& other) noexcept {
 	if(&other != this) {
-		projectFile = std::move(other.getProjectFile());
-		saved = std::move(other.isSaved());
-		project = std::move(other.getProjectNode());
-		breakpoints = std::move(other.getBreakpoints());
+		waitForSaved();
+		waitForLoaded();
+		// Not through the getters, which would make copies
+		projectFile = std::move(other.projectFile);
+		saved = other.saved;
+		project = std::move(other.project);
+		breakpointsFormat = other.breakpointsFormat;
+		breakpoints = std::move(other.breakpoints);
 	}
 	return *this;
 }
 
+void ProjectManager::open(std::string const& projectFile) {
+	waitForSaved();
+
+	QFile file(QString::fromStdString(projectFile));
+	if(!file.open(QIODevice::ReadOnly)) {
+		throw std::runtime_error("Could not open " + projectFile);
+	}
+	QByteArray content = file.readAll();
+
+	// The breakpoints are written last and are by far the longest part of
+	// the file, only what comes before them is needed to start the video
+	int breakpointsStart = 0;
+	if(!content.startsWith("breakpoints:")) {
+		breakpointsStart = content.indexOf("\nbreakpoints:");
+		if(breakpointsStart >= 0) {
+			++breakpointsStart;
+		}
+	}
+	QByteArray header = (breakpointsStart >= 0) ? content.left(breakpointsStart) : content;
+	QByteArray rest = (breakpointsStart >= 0) ? content.mid(breakpointsStart) : QByteArray();
+
+	YAML::Node headerNode = YAML::Load(header.toStdString());
+
+	this->projectFile = projectFile;
+	saved = true;
+	project = headerNode.IsMap() ? headerNode : YAML::Node(YAML::NodeType::Map);
+	breakpoints = BreakpointSet();
+	lastChange = BreakpointsChange();
+	loadError.clear();
+
+	if(project["breakpoints-file"]) {
+		breakpointsFormat = BreakpointsFormat::Binary;
+		QString breakpointsFile = QString::fromStdString(getBreakpointsFile());
+		startLoad(rest, [breakpointsFile]() { return BreakpointsFile::read(breakpointsFile); });
+	} else {
+		breakpointsFormat = BreakpointsFormat::Yaml;
+		// Not written by slideo, converted right away
+		BreakpointSet inlineBreakpoints;
+		if(project["breakpoints"]) {
+			inlineBreakpoints = project["breakpoints"].as<BreakpointSet>();
+			project.remove("breakpoints");
+		}
+		startLoad(rest, [inlineBreakpoints]() { return inlineBreakpoints; });
+	}
+}
+
+bool ProjectManager::isLoaded() const {
+	return !loading;
+}
+
+void ProjectManager::waitForLoaded() {
+	if(loading) {
+		loadWatcher.waitForFinished();
+		finishLoad();
+	}
+}
+
 std::string const& ProjectManager::getProjectFile() const {
 	return projectFile;
 }
@@ -98,9 +211,48 @@ YAML::Node const& ProjectManager::getProjectNode() const {
 }
 
 std::string ProjectManager::getVideoFile() const {
+	if(project["clips"]) {
+		return project["clips"][0]["file"].as<std::string>();
+	}
 	return project["video-file"].as<std::string>();
 }
 
+Timeline ProjectManager::getTimeline() const {
+	QDir baseDirectory(QString::fromStdString(getProjectFileLocation()));
+	auto path = [&baseDirectory](YAML::Node const& file) {
+		return baseDirectory.filePath(QString::fromStdString(file.as<std::string>()));
+	};
+
+	Timeline timeline;
+	if(project["clips"]) {
+		for(YAML::Node const& clip : project["clips"]) {
+			timeline.append(path(clip["file"]), clip["duration"] ? clip["duration"].as<qint64>() : 0);
+		}
+	} else if(project["video-file"]) {
+		timeline.append(path(project["video-file"]), 0);
+	}
+	return timeline;
+}
+
+void ProjectManager::addClip(std::string const& videoFile, qint64 duration) {
+	YAML::Node clip;
+	clip["file"] = videoFile;
+	clip["duration"] = duration;
+	clipsNode().push_back(clip);
+
+	saved = false;
+	++revision;
+	emit clipsChanged();
+}
+
+void ProjectManager::setClipDuration(std::size_t index, qint64 duration) {
+	clipsNode()[index]["duration"] = duration;
+
+	saved = false;
+	++revision;
+	emit clipsChanged();
+}
+
 std::string ProjectManager::getProjectFileLocation() const {
 	return QFileInfo(QString::fromStdString(projectFile)).absolutePath().toStdString();
 }
@@ -109,67 +261,322 @@ std::string ProjectManager::getProjectFileBaseName() const {
 	return QFileInfo(QString::fromStdString(projectFile)).baseName().toStdString();
 }
 
-std::set<qint64> const& ProjectManager::getBreakpoints() const {
+std::string ProjectManager::getBreakpointsFile() const {
+	QString fileName;
+	if(project["breakpoints-file"]) {
+		fileName = QString::fromStdString(project["breakpoints-file"].as<std::string>());
+	} else {
+		fileName = QFileInfo(QString::fromStdString(projectFile)).completeBaseName() + ".eob";
+	}
+	return QDir(QString::fromStdString(getProjectFileLocation())).filePath(fileName).toStdString();
+}
+
+std::string ProjectManager::getKeyframeIndexFile() const {
+	QString fileName = QFileInfo(QString::fromStdString(projectFile)).completeBaseName() + ".eok";
+	return QDir(QString::fromStdString(getProjectFileLocation())).filePath(fileName).toStdString();
+}
+
+ProjectManager::BreakpointsFormat ProjectManager::getBreakpointsFormat() const {
+	return breakpointsFormat;
+}
+
+void ProjectManager::setBreakpointsFormat(BreakpointsFormat format) {
+	breakpointsFormat = format;
+}
+
+void ProjectManager::convertProject(std::string const& projectFile, BreakpointsFormat format) {
+	ProjectManager project(projectFile);
+	if(project.getBreakpointsFormat() != format) {
+		project.setBreakpointsFormat(format);
+		project.saveProject();
+		project.waitForSaved();
+	}
+}
+
+BreakpointSet const& ProjectManager::getBreakpoints() const {
 	return breakpoints;
 }
 
-void ProjectManager::setBreakpoints(std::set<qint64> const& breakpoints) {
+void ProjectManager::setBreakpoints(BreakpointSet const& breakpoints) {
 	if(this->breakpoints != breakpoints) {
+		BreakpointsChange change = this->breakpoints.changeTo(breakpoints);
 		this->breakpoints = breakpoints;
-		saved = false;
-		emit breakpointsChanged();
+		breakpointsModified(std::move(change));
 	}
 }
 
-void ProjectManager::setBreakpoints(std::set<qint64>&& breakpoints) {
+void ProjectManager::setBreakpoints(BreakpointSet&& breakpoints) {
 	if(this->breakpoints != breakpoints) {
-		this->breakpoints = breakpoints;
-		saved = false;
-		emit breakpointsChanged();
+		BreakpointsChange change = this->breakpoints.changeTo(breakpoints);
+		this->breakpoints = std::move(breakpoints);
+		breakpointsModified(std::move(change));
 	}
 }
 
 void ProjectManager::addBreakpoint(qint64 const breakpoint) {
-	breakpoints.insert(breakpoint);
-	saved = false;
-	emit breakpointsChanged();
+	BreakpointsChange change;
+	if(breakpoints.insert(breakpoint)) {
+		change.inserted.push_back(breakpoint);
+	}
+	breakpointsModified(std::move(change));
 }
 
 void ProjectManager::addBreakpoints(std::vector<qint64> const& breakpoints) {
-	for(qint64 const& breakpoint : breakpoints) {
-		this->breakpoints.insert(breakpoint);
-	}
-	saved = false;
-	emit breakpointsChanged();
+	BreakpointsChange change;
+	change.inserted = this->breakpoints.insert(breakpoints);
+	breakpointsModified(std::move(change));
 }
 
 void ProjectManager::removeBreakpoint(qint64 const breakpoint) {
-	breakpoints.erase(breakpoint);
-	saved = false;
-	emit breakpointsChanged();
+	BreakpointsChange change;
+	if(breakpoints.erase(breakpoint)) {
+		change.removed.push_back(breakpoint);
+	}
+	breakpointsModified(std::move(change));
 }
 
 void ProjectManager::removeBreakpoints(std::vector<qint64> const& breakpoints) {
-	for(qint64 const breakpoint : breakpoints) {
-		this->breakpoints.erase(breakpoint);
+	BreakpointsChange change;
+	change.removed = this->breakpoints.erase(breakpoints);
+	breakpointsModified(std::move(change));
+}
+
+void ProjectManager::replaceBreakpoint(qint64 const oldPosition, qint64 const newPosition) {
+	if(oldPosition != newPosition) {
+		applyChange({{newPosition}, {oldPosition}});
+	}
+}
+
+void ProjectManager::applyChange(BreakpointsChange const& change) {
+	breakpointsModified(breakpoints.apply(change));
+}
+
+BreakpointsChange const& ProjectManager::getLastChange() const {
+	return lastChange;
+}
+
+void ProjectManager::breakpointsModified(BreakpointsChange&& change) {
+	if(change.empty()) {
+		return;
 	}
+
+	lastChange = std::move(change);
 	saved = false;
+	++revision;
+
+	emit breakpointsChangeStarted();
+	emitRowChanges();
 	emit breakpointsChanged();
 }
 
-void ProjectManager::replaceBreakpoint(qint64 const oldPosition, qint64 const newPosition) {
-	if(oldPosition != newPosition) {
-		removeBreakpoint(oldPosition);
-		addBreakpoint(newPosition);
-		saved = false;
-		emit breakpointsChanged();
+void ProjectManager::emitRowChanges() const {
+	std::vector<qint64> const& inserted = lastChange.inserted;
+	std::vector<qint64> const& removed = lastChange.removed;
+
+	// The breakpoints are already modified, so the row of each removed
+	// breakpoint is computed from the new breakpoints and the change.
+	// Removing in ascending order, the row of a removed breakpoint is the
+	// number of kept breakpoints lower than it.
+	auto removedRow = [this, &inserted](qint64 breakpoint) {
+		return static_cast<int>(breakpoints.lowerBound(breakpoint) - countLess(inserted, breakpoint));
+	};
+
+	if(removed.size() == 1 && inserted.size() == 1) {
+		emit breakpointMoved(removedRow(removed.front()),
+		                     static_cast<int>(breakpoints.lowerBound(inserted.front())));
+		return;
+	}
+
+	for(auto it = removed.cbegin(); it != removed.cend();) {
+		// Consecutive rows all have the same row once the previous ones are removed
+		int row = removedRow(*it);
+		auto runEnd = it + 1;
+		while(runEnd != removed.cend() && removedRow(*runEnd) == row) {
+			++runEnd;
+		}
+		emit breakpointsRemoved(row, row + (runEnd - it) - 1);
+		it = runEnd;
+	}
+
+	// Inserting in ascending order, the row of an inserted breakpoint is its
+	// final row
+	for(auto it = inserted.cbegin(); it != inserted.cend();) {
+		int row = breakpoints.lowerBound(*it);
+		auto runEnd = it + 1;
+		while(runEnd != inserted.cend() &&
+		      static_cast<int>(breakpoints.lowerBound(*runEnd)) == row + (runEnd - it)) {
+			++runEnd;
+		}
+		emit breakpointsInserted(row, row + (runEnd - it) - 1);
+		it = runEnd;
 	}
 }
 
 void ProjectManager::saveProject() {
-	project["breakpoints"] = breakpoints;
+	// Would write the breakpoints loaded so far
+	waitForLoaded();
+	if(!loadError.isEmpty()) {
+		emit projectSaved(false, "The breakpoints of the project could not be read");
+		return;
+	}
 
-	std::ofstream fileStream(projectFile);
-	fileStream << project << std::endl;
-	saved = true;
+	if(saving) {
+		queuedSaves.push_back(snapshot());
+	} else {
+		startSave(snapshot());
+	}
+	emit saveStarted();
+}
+
+void ProjectManager::waitForSaved() {
+	while(saving) {
+		saveWatcher.waitForFinished();
+		finishSave();
+	}
+}
+
+void ProjectManager::finishSave() {
+	if(!saving || !saveWatcher.isFinished()) {
+		return;
+	}
+
+	saving = false;
+	QString error = saveWatcher.result();
+
+	if(error.isEmpty() && savingRevision == revision) {
+		saved = true;
+	}
+
+	if(!queuedSaves.empty()) {
+		Snapshot next = std::move(queuedSaves.front());
+		queuedSaves.pop_front();
+		startSave(next);
+	}
+
+	emit projectSaved(error.isEmpty(), error);
+}
+
+void ProjectManager::finishLoad() {
+	if(!loading || !loadWatcher.isFinished()) {
+		return;
+	}
+
+	loading = false;
+	Loaded loaded = loadWatcher.result();
+	loadError = loaded.error;
+
+	if(loadError.isEmpty()) {
+		breakpoints = std::move(loaded.breakpoints);
+		// Keys written after the breakpoints by another tool
+		for(auto const& entry : loaded.rest) {
+			if(entry.first.as<std::string>() != "breakpoints") {
+				project[entry.first] = entry.second;
+			}
+		}
+	}
+
+	emit breakpointsLoaded(loadError.isEmpty(), loadError);
+}
+
+void ProjectManager::startLoad(QByteArray const& rest,
+                               std::function<BreakpointSet()> const& readBreakpoints) {
+	loading = true;
+	loadWatcher.setFuture(QtConcurrent::run([rest, readBreakpoints]() {
+		Loaded loaded;
+		try {
+			loaded.breakpoints = readBreakpoints();
+			if(!rest.isEmpty()) {
+				loaded.rest = YAML::Load(rest.toStdString());
+				if(loaded.rest["breakpoints"]) {
+					loaded.breakpoints = loaded.rest["breakpoints"].as<BreakpointSet>();
+				}
+			}
+		} catch(std::exception const& e) {
+			loaded.error = QString::fromLocal8Bit(e.what());
+		}
+		return loaded;
+	}));
+}
+
+void ProjectManager::startSave(Snapshot const& snapshot) {
+	savingRevision = snapshot.revision;
+	saving = true;
+	saveWatcher.setFuture(QtConcurrent::run([snapshot]() { return writeProject(snapshot); }));
+}
+
+YAML::Node ProjectManager::clipsNode() {
+	if(!project["clips"]) {
+		YAML::Node clip;
+		clip["file"] = project["video-file"].as<std::string>();
+		clip["duration"] = 0;
+		project["clips"].push_back(clip);
+		project.remove("video-file");
+	}
+	return project["clips"];
+}
+
+ProjectManager::Snapshot ProjectManager::snapshot() {
+	// The node is cloned as YAML::Node copies share their content
+	Snapshot snapshot{projectFile,
+	                  YAML::Clone(project),
+	                  breakpointsFormat,
+	                  breakpoints,
+	                  getBreakpointsFile(),
+	                  false,
+	                  revision};
+
+	if(breakpointsFormat == BreakpointsFormat::Binary) {
+		project["breakpoints-file"] =
+		  QFileInfo(QString::fromStdString(snapshot.breakpointsFile)).fileName().toStdString();
+	} else if(project["breakpoints-file"]) {
+		// Converted from the binary format
+		snapshot.removeBreakpointsFile = true;
+		project.remove("breakpoints-file");
+	}
+
+	return snapshot;
+}
+
+QString ProjectManager::writeProject(Snapshot const& snapshot) {
+	try {
+		// Written by hand rather than through the YAML::Node so the breakpoints
+		// do not need to be converted to nodes
+		YAML::Emitter emitter;
+		emitter << YAML::BeginMap;
+		for(auto const& entry : snapshot.project) {
+			std::string key = entry.first.as<std::string>();
+			if(key != "breakpoints" && key != "breakpoints-file") {
+				emitter << YAML::Key << entry.first << YAML::Value << entry.second;
+			}
+		}
+
+		QString breakpointsFile = QString::fromStdString(snapshot.breakpointsFile);
+		if(snapshot.breakpointsFormat == BreakpointsFormat::Binary) {
+			BreakpointsFile::write(breakpointsFile, snapshot.breakpoints);
+			emitter << YAML::Key << "breakpoints-file" << YAML::Value
+			        << QFileInfo(breakpointsFile).fileName().toStdString();
+		} else {
+			emitter << YAML::Key << "breakpoints" << YAML::Value << YAML::BeginSeq;
+			for(qint64 breakpoint : snapshot.breakpoints) {
+				emitter << breakpoint;
+			}
+			emitter << YAML::EndSeq;
+		}
+		emitter << YAML::EndMap;
+
+		QSaveFile file(QString::fromStdString(snapshot.projectFile));
+		if(!file.open(QIODevice::WriteOnly) ||
+		   file.write(emitter.c_str(), emitter.size()) != static_cast<qint64>(emitter.size()) ||
+		   file.write("\n") != 1 || !file.commit()) {
+			return file.errorString();
+		}
+
+		if(snapshot.removeBreakpointsFile) {
+			QFile::remove(breakpointsFile);
+		}
+	} catch(std::exception const& e) {
+		return QString::fromLocal8Bit(e.what());
+	}
+
+	return QString();
 }
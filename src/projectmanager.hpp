@@ -1,8 +1,14 @@
 #pragma once
 
+#include "breakpointset.hpp"
+#include "timeline.hpp"
+
 #include <QObject>
+#include <QFutureWatcher>
+#include <QString>
 
-#include <set>
+#include <deque>
+#include <functional>
 #include <vector>
 #include <yaml-cpp/yaml.h>
 
@@ -15,11 +21,27 @@ class ProjectManager : public QObject {
 	Q_OBJECT
 
 public:
+	/*! \brief How the breakpoints are stored in the project file.
+	 */
+	enum class BreakpointsFormat {
+		//! As a sequence in the YAML project file.
+		Yaml,
+		//! In a separate compact binary file, see BreakpointsFile.
+		Binary
+	};
+
 	/*! \brief ProjectManager default constructor.
 	 *
 	 * This will construct a dummy project, for when no project is loaded yet.
 	 */
-	ProjectManager() = default;
+	ProjectManager();
+
+	/*! \brief ProjectManager destructor.
+	 *
+	 * Waits for the current and the queued saves, and for the loading of the
+	 * breakpoints. No signal is emitted meanwhile.
+	 */
+	~ProjectManager();
 
 	/*! \brief ProjectManager copy constructor.
 	 */
@@ -39,7 +61,8 @@ public:
 
 	/*! \brief ProjectManager constructor.
 	 *
-	 * Loads the project file into Yaml node.
+	 * Loads the project file into Yaml node, and its breakpoints. Throws
+	 * std::runtime_error or YAML::Exception if the project cannot be read.
 	 *
 	 * \param projectFile the project file path.
 	 */
@@ -47,13 +70,36 @@ public:
 
 	/*! \brief ProjectManager constructor specifying the video file path.
 	 *
-	 * Creates the project file with a default template.
+	 * Creates the project file with a default template. The file is written
+	 * synchronously.
 	 *
 	 * \param projectFile the project file path.
 	 * \param videoFile the path of the video file.
 	 */
 	ProjectManager(std::string projectFile, std::string videoFile);
 
+	/*! \brief Open a project file, loading its breakpoints in the background.
+	 *
+	 * Only the part of the file before the breakpoints is read right away, so
+	 * the clips are available immediately. The breakpoints are empty until
+	 * breakpointsLoaded is emitted, and must not be modified before. Throws
+	 * std::runtime_error or YAML::Exception if the project cannot be read.
+	 *
+	 * \param projectFile the project file path.
+	 */
+	void open(std::string const& projectFile);
+
+	/*! \brief Returns false while the breakpoints are loaded, see open.
+	 */
+	bool isLoaded() const;
+
+	/*! \brief Wait for the breakpoints to be loaded.
+	 *
+	 * breakpointsLoaded is emitted before returning if they were being
+	 * loaded.
+	 */
+	void waitForLoaded();
+
 	/*! \brief projectFile attribute getter.
 	 */
 	std::string const& getProjectFile() const;
@@ -68,10 +114,37 @@ public:
 
 	/*! \brief Get the path of the video file for the project.
 	 *
-	 * \return the video file for this project.
+	 * \return the video file of the first clip of this project.
 	 */
 	std::string getVideoFile() const;
 
+	/*! \brief Get the video clips of the project.
+	 *
+	 * The video files are stored relatively to the project file's directory,
+	 * the paths of the timeline are absolute. A project created with a single
+	 * video file has a single clip, of unknown duration.
+	 *
+	 * \return the timeline of this project.
+	 */
+	Timeline getTimeline() const;
+
+	/*! \brief Add a video clip at the end of the project.
+	 *
+	 * The duration of the previous clips must be known, see setClipDuration.
+	 *
+	 * \param videoFile the path of the video file, relative to the project
+	 *        file's directory.
+	 * \param duration the duration of the clip in msecs.
+	 */
+	void addClip(std::string const& videoFile, qint64 duration);
+
+	/*! \brief Set the duration of a clip.
+	 *
+	 * \param index the index of the clip in the timeline.
+	 * \param duration the duration of the clip in msecs.
+	 */
+	void setClipDuration(std::size_t index, qint64 duration);
+
 	/*! \brief Get the path leading to the project file
 	 *
 	 * \return the path to the project file.
@@ -84,23 +157,56 @@ public:
 	 */
 	std::string getProjectFileBaseName() const;
 
+	/*! \brief Get the path of the binary breakpoints file for this project.
+	 *
+	 * This file is only used with the Binary breakpoints format.
+	 *
+	 * \return the path of the breakpoints file.
+	 */
+	std::string getBreakpointsFile() const;
+
+	/*! \brief Get the path of the keyframe index cache for this project.
+	 *
+	 * \return the path of the keyframe index file.
+	 */
+	std::string getKeyframeIndexFile() const;
+
+	/*! \brief breakpointsFormat attribute getter.
+	 */
+	BreakpointsFormat getBreakpointsFormat() const;
+
+	/*! \brief Set how the breakpoints are stored.
+	 *
+	 * Takes effect on the next save.
+	 *
+	 * \param format the new format.
+	 */
+	void setBreakpointsFormat(BreakpointsFormat format);
+
+	/*! \brief Convert a project file to the given breakpoints format.
+	 *
+	 * \param projectFile the project file path.
+	 * \param format the new format.
+	 */
+	static void convertProject(std::string const& projectFile, BreakpointsFormat format);
+
 	/*! \brief Get the breakpoints for this project.
 	 *
 	 * \return the breakpoints of this project.
 	 */
-	std::set<qint64> const& getBreakpoints() const;
+	BreakpointSet const& getBreakpoints() const;
 
 	/*! \brief Set the breakpoints for this project.
 	 *
 	 * \param breakpoints Breakpoints to set as the project's breakpoints.
 	 */
-	void setBreakpoints(std::set<qint64> const& breakpoints);
+	void setBreakpoints(BreakpointSet const& breakpoints);
 
 	/*! \brief Set the breakpoints for this project.
 	 *
 	 * \param breakpoints Breakpoints to set as the project's breakpoints.
 	 */
-	void setBreakpoints(std::set<qint64>&& breakpoints);
+	void setBreakpoints(BreakpointSet&& breakpoints);
 
 	/*! \brief Add a breakpoint to the project.
 	 *
@@ -144,21 +250,211 @@ public:
 	 */
 	void replaceBreakpoint(qint64 const oldPosition, qint64 const newPosition);
 
+	/*! \brief Apply a change to the project's breakpoints.
+	 *
+	 * Mainly used by History to undo/redo.
+	 *
+	 * \param change the change to apply.
+	 */
+	void applyChange(BreakpointsChange const& change);
+
+	/*! \brief Get the last change made to the breakpoints.
+	 *
+	 * Is valid when breakpointsChanged is emitted.
+	 *
+	 * \return the breakpoints inserted and removed by the last modification.
+	 */
+	BreakpointsChange const& getLastChange() const;
+
+	/*! \brief Wait for the current save to finish.
+	 *
+	 * projectSaved is emitted before returning if a save was running.
+	 */
+	void waitForSaved();
+
 public slots:
 	/*! \brief Saves the project to the project file.
+	 *
+	 * The project is snapshotted and written in a worker thread, to a
+	 * temporary file which then replaces the project file. projectSaved is
+	 * emitted when done, once per call. If a save is already running, the
+	 * snapshot is written once it is done.
 	 */
 	void saveProject();
 
 signals:
+	/*! \brief Signal emitted before the notifications of a change.
+	 *
+	 * Each modification of the breakpoints (even a batch one like
+	 * addBreakpoints) emits breakpointsChangeStarted, then the
+	 * breakpointsRemoved, breakpointsInserted or breakpointMoved
+	 * notifications, then breakpointsChanged. Nothing is emitted if the
+	 * modification did not change anything.
+	 */
+	void breakpointsChangeStarted() const;
+
+	/*! \brief Signal emitted when breakpoints were removed.
+	 *
+	 * The breakpoints are already removed. The rows are the ones the removed
+	 * breakpoints had when the previous notifications of the same change were
+	 * applied in order, like QAbstractItemModel::rowsRemoved.
+	 *
+	 * \param first the row of the first removed breakpoint.
+	 * \param last the row of the last removed breakpoint.
+	 */
+	void breakpointsRemoved(int first, int last) const;
+
+	/*! \brief Signal emitted when breakpoints were inserted.
+	 *
+	 * Emitted after the breakpointsRemoved notifications of the same change.
+	 * The rows are the rows of the inserted breakpoints once the previous
+	 * notifications were applied in order, like
+	 * QAbstractItemModel::rowsInserted.
+	 *
+	 * \param first the row of the first inserted breakpoint.
+	 * \param last the row of the last inserted breakpoint.
+	 */
+	void breakpointsInserted(int first, int last) const;
+
+	/*! \brief Signal emitted when a single breakpoint was replaced by an other.
+	 *
+	 * Emitted instead of breakpointsRemoved and breakpointsInserted.
+	 *
+	 * \param from the row of the breakpoint before the change.
+	 * \param to the row of the breakpoint after the change.
+	 */
+	void breakpointMoved(int from, int to) const;
+
 	/*! \brief Signal emitted when the project's breakpoints are changed.
+	 *
+	 * Emitted once per modification, after the detailed notifications. The
+	 * change itself is available through getLastChange.
 	 */
 	void breakpointsChanged() const;
 
+	/*! \brief Signal emitted when saveProject takes the snapshot to save.
+	 *
+	 * Every change notified before this signal is part of the save.
+	 */
+	void saveStarted() const;
+
+	/*! \brief Signal emitted when a save started by saveProject is done.
+	 *
+	 * \param success true if the project was written.
+	 * \param error the reason of the failure, if any.
+	 */
+	void projectSaved(bool success, QString const& error) const;
+
+	/*! \brief Signal emitted when the clips of the project are changed.
+	 */
+	void clipsChanged() const;
+
+	/*! \brief Signal emitted when the breakpoints opened by open are loaded.
+	 *
+	 * The project has no breakpoints if the loading failed.
+	 *
+	 * \param success true if the breakpoints were read.
+	 * \param error the reason of the failure, if any.
+	 */
+	void breakpointsLoaded(bool success, QString const& error) const;
+
+protected slots:
+	/*! \brief Handle the end of the save running in the worker thread.
+	 *
+	 * Does nothing if the save is not finished or was already handled.
+	 */
+	void finishSave();
+
+	/*! \brief Handle the end of the loading running in the worker thread.
+	 *
+	 * Does nothing if the loading is not finished or was already handled.
+	 */
+	void finishLoad();
+
 protected:
+	/*! \brief Everything needed to write the project, independent of this
+	 * object so it can be written in a worker thread.
+	 */
+	struct Snapshot {
+		std::string projectFile;
+		YAML::Node project;
+		BreakpointsFormat breakpointsFormat;
+		BreakpointSet breakpoints;
+		std::string breakpointsFile;
+		bool removeBreakpointsFile;
+		quint64 revision;
+	};
+
+	/*! \brief Take a snapshot of the project for writing.
+	 */
+	Snapshot snapshot();
+
+	/*! \brief Write a project snapshot to the disk.
+	 *
+	 * Each file is written to a temporary file which is then renamed, so an
+	 * interrupted save does not leave a truncated project.
+	 *
+	 * \param snapshot the snapshot to write.
+	 * \return an empty string on success, the error otherwise.
+	 */
+	static QString writeProject(Snapshot const& snapshot);
+
+	/*! \brief What the worker thread reads when a project is opened.
+	 */
+	struct Loaded {
+		BreakpointSet breakpoints;
+		// The end of the project file, starting at the breakpoints
+		YAML::Node rest;
+		QString error;
+	};
+
+	/*! \brief Start reading the breakpoints in a worker thread.
+	 *
+	 * \param rest the end of the project file, starting at the breakpoints.
+	 * \param readBreakpoints reads the breakpoints stored elsewhere.
+	 */
+	void startLoad(QByteArray const& rest, std::function<BreakpointSet()> const& readBreakpoints);
+
+	/*! \brief Start writing a snapshot in a worker thread.
+	 *
+	 * \param snapshot the snapshot to write.
+	 */
+	void startSave(Snapshot const& snapshot);
+
+	/*! \brief Get the clips node of the project.
+	 *
+	 * A project with a single "video-file" is converted to a "clips" sequence
+	 * first.
+	 */
+	YAML::Node clipsNode();
+
 	std::string projectFile;
 	bool saved = true;
 	YAML::Node project;
-	std::set<qint64> breakpoints;
+	BreakpointsFormat breakpointsFormat = BreakpointsFormat::Yaml;
+	BreakpointSet breakpoints;
+	BreakpointsChange lastChange;
+
+	// Incremented on each change, to know if the saved snapshot is still current
+	quint64 revision = 0;
+	quint64 savingRevision = 0;
+	bool saving = false;
+	std::deque<Snapshot> queuedSaves;
+	QFutureWatcher<QString> saveWatcher;
+
+	bool loading = false;
+	QString loadError;
+	QFutureWatcher<Loaded> loadWatcher;
+
+	/*! \brief Record the last change and notify about it.
+	 *
+	 * \param change the change which was made to the breakpoints.
+	 */
+	void breakpointsModified(BreakpointsChange&& change);
+
+	/*! \brief Emit the detailed notifications of the last change.
+	 */
+	void emitRowChanges() const;
 
 	// Needed to modify the "saved" state
 	friend class History;
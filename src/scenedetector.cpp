@@ -0,0 +1,129 @@
+#include "scenedetector.hpp"
+
+#include "timelinedecoder.hpp"
+
+#include <QtConcurrent>
+
+#include <algorithm>
+#include <cstdlib>
+#include <exception>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+namespace {
+	struct Segment {
+		qint64 from;
+		qint64 to;
+	};
+
+	// Function object so QtConcurrent can deduce the result type
+	struct SegmentDetector {
+		using result_type = std::vector<SceneDetector::Cut>;
+
+		Timeline timeline;
+		SceneDetector::Settings settings;
+
+		result_type operator()(Segment const& segment) const {
+			result_type cuts;
+			try {
+				TimelineDecoder decoder(timeline);
+				decoder.setFastDecoding(true);
+
+				QSize size = settings.analysisSize;
+				double pixels = static_cast<double>(size.width()) * size.height();
+				std::vector<uchar> previous, current;
+
+				if(!decoder.decodeFrameAt(segment.from) || !decoder.getFrameLuma(size, previous)) {
+					return cuts;
+				}
+
+				// The first frame after the segment is compared too, so the cuts
+				// between two segments are not missed
+				while(decoder.getFramePosition() < segment.to && decoder.decodeNextFrame()) {
+					if(!decoder.getFrameLuma(size, current)) {
+						break;
+					}
+
+					double score =
+					  SceneDetector::sumOfAbsoluteDifferences(previous.data(), current.data(),
+					                                          current.size()) / pixels;
+					if(score > settings.threshold) {
+						cuts.push_back({decoder.getFramePosition(), score});
+					}
+					std::swap(previous, current);
+				}
+			} catch(std::exception const&) {
+				// The segment cannot be decoded, no cut is detected in it
+			}
+			return cuts;
+		}
+	};
+}
+
+QFuture<std::vector<SceneDetector::Cut>> SceneDetector::start(Timeline const& timeline,
+                                                              Settings const& settings) {
+	std::vector<Segment> segments;
+	qint64 segmentDuration = std::max<qint64>(settings.segmentDuration, 1);
+	for(qint64 from = settings.from ; from < settings.to ; from += segmentDuration) {
+		segments.push_back({from, std::min(from + segmentDuration, settings.to)});
+	}
+
+	return QtConcurrent::mapped(segments, SegmentDetector{timeline, settings});
+}
+
+std::vector<qint64> SceneDetector::breakpoints(QList<std::vector<Cut>> const& segments,
+                                               Settings const& settings) {
+	std::vector<Cut> cuts;
+	for(std::vector<Cut> const& segment : segments) {
+		cuts.insert(cuts.end(), segment.cbegin(), segment.cend());
+	}
+	std::sort(cuts.begin(), cuts.end(),
+	          [](Cut const& a, Cut const& b) { return a.position < b.position; });
+
+	// Transitions (fades, animations) give several cuts in a row
+	std::vector<Cut> kept;
+	for(Cut const& cut : cuts) {
+		if(!kept.empty() && cut.position - kept.back().position < settings.minInterval) {
+			if(cut.score > kept.back().score) {
+				kept.back() = cut;
+			}
+		} else {
+			kept.push_back(cut);
+		}
+	}
+
+	std::vector<qint64> positions;
+	positions.reserve(kept.size());
+	for(Cut const& cut : kept) {
+		positions.push_back(cut.position);
+	}
+	return positions;
+}
+
+quint64 SceneDetector::sumOfAbsoluteDifferences(uchar const* first, uchar const* second,
+                                                std::size_t size) {
+	quint64 sum = 0;
+	std::size_t i = 0;
+
+#ifdef __SSE2__
+	// _mm_sad_epu8 gives two 16 bits sums for 16 bytes, accumulated in two
+	// 64 bits lanes
+	__m128i total = _mm_setzero_si128();
+	for( ; i + 16 <= size ; i += 16) {
+		__m128i a = _mm_loadu_si128(reinterpret_cast<__m128i const*>(first + i));
+		__m128i b = _mm_loadu_si128(reinterpret_cast<__m128i const*>(second + i));
+		total = _mm_add_epi64(total, _mm_sad_epu8(a, b));
+	}
+
+	alignas(16) quint64 lanes[2];
+	_mm_store_si128(reinterpret_cast<__m128i*>(lanes), total);
+	sum = lanes[0] + lanes[1];
+#endif
+
+	for( ; i < size ; ++i) {
+		sum += std::abs(static_cast<int>(first[i]) - static_cast<int>(second[i]));
+	}
+	return sum;
+}
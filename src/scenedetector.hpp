@@ -0,0 +1,91 @@
+#pragma once
+
+#include "timeline.hpp"
+
+#include <QFuture>
+#include <QList>
+#include <QSize>
+#include <QString>
+
+#include <vector>
+
+/*! \brief Detects the scene changes (e.g. slide changes) of a timeline.
+ *
+ * The timeline is split in segments which are decoded in parallel, at a low
+ * resolution. A cut is detected when the mean luma difference between two
+ * consecutive frames exceeds a threshold.
+ */
+namespace SceneDetector {
+
+	/*! \brief Parameters of the detection.
+	 */
+	struct Settings {
+		/*! \brief Part of the timeline to analyze, in msecs.
+		 */
+		qint64 from = 0;
+		qint64 to = 0;
+
+		/*! \brief Mean luma difference (0-255) above which there is a cut.
+		 */
+		int threshold = 12;
+
+		/*! \brief Minimum duration between two cuts, in msecs.
+		 *
+		 * Only the most pronounced cut is kept when several are closer.
+		 */
+		qint64 minInterval = 1'000;
+
+		/*! \brief Size of the frames when comparing them.
+		 */
+		QSize analysisSize = QSize(160, 90);
+
+		/*! \brief Duration of the segments decoded in parallel, in msecs.
+		 */
+		qint64 segmentDuration = 30'000;
+	};
+
+	/*! \brief A detected cut.
+	 */
+	struct Cut {
+		/*! \brief Position of the first frame of the new scene, in msecs.
+		 */
+		qint64 position;
+
+		/*! \brief Mean luma difference with the previous frame (0-255).
+		 */
+		double score;
+	};
+
+	/*! \brief Start the detection in the background.
+	 *
+	 * Each result of the future contains the cuts of one segment. The
+	 * progress of the future is the number of analyzed segments.
+	 *
+	 * \param timeline the clips to analyze.
+	 * \param settings the parameters of the detection.
+	 * \return the future cuts.
+	 */
+	QFuture<std::vector<Cut>> start(Timeline const& timeline, Settings const& settings);
+
+	/*! \brief Get the breakpoints from the cuts of all the segments.
+	 *
+	 * Applies the minimum interval.
+	 *
+	 * \param segments the results of the future returned by start.
+	 * \param settings the parameters of the detection.
+	 * \return the positions of the cuts, sorted.
+	 */
+	std::vector<qint64> breakpoints(QList<std::vector<Cut>> const& segments,
+	                                Settings const& settings);
+
+	/*! \brief Sum of the absolute differences between two buffers.
+	 *
+	 * Uses SSE2 when available.
+	 *
+	 * \param first the first buffer.
+	 * \param second the second buffer.
+	 * \param size the size of both buffers.
+	 * \return the sum.
+	 */
+	quint64 sumOfAbsoluteDifferences(uchar const* first, uchar const* second, std::size_t size);
+}
@@ -0,0 +1,90 @@
+#include "seekbar.hpp"
+
+#include <QMouseEvent>
+#include <QPainter>
+#include <QPixmap>
+#include <QStyle>
+#include <QStyleOptionSlider>
+#include <QTime>
+
+SeekBar::SeekBar(QWidget* parent)
+      : QSlider(Qt::Horizontal, parent)
+      , previewLabel(this, Qt::ToolTip) {
+	setMouseTracking(true);
+
+	previewLabel.setAlignment(Qt::AlignCenter);
+	previewLabel.setStyleSheet("background-color: black; color: white;");
+
+	connect(this, SIGNAL(sliderMoved(int)), this, SLOT(handleSliderMoved(int)));
+	connect(this, SIGNAL(sliderReleased()), this, SLOT(handleSliderReleased()));
+}
+
+void SeekBar::setPreview(SeekPreview const* preview) {
+	this->preview = preview;
+}
+
+void SeekBar::handleSliderMoved(int position) {
+	if(preview && preview->isAvailable()) {
+		QStyleOptionSlider option;
+		initStyleOption(&option);
+		QRect handle = style()->subControlRect(QStyle::CC_Slider, &option, QStyle::SC_SliderHandle, this);
+		showPreview(position, handle.center().x());
+	} else {
+		emit scrubbed(position);
+	}
+}
+
+void SeekBar::handleSliderReleased() {
+	previewLabel.hide();
+	emit scrubFinished(value());
+}
+
+void SeekBar::mouseMoveEvent(QMouseEvent* event) {
+	// While dragging, the preview follows the handle instead
+	if(!isSliderDown() && preview && preview->isAvailable() && maximum() > minimum()) {
+		showPreview(positionAt(event->pos().x()), event->pos().x());
+	}
+	QSlider::mouseMoveEvent(event);
+}
+
+void SeekBar::leaveEvent(QEvent* event) {
+	if(!isSliderDown()) {
+		previewLabel.hide();
+	}
+	QSlider::leaveEvent(event);
+}
+
+int SeekBar::positionAt(int x) const {
+	QStyleOptionSlider option;
+	initStyleOption(&option);
+	QRect groove = style()->subControlRect(QStyle::CC_Slider, &option, QStyle::SC_SliderGroove, this);
+	QRect handle = style()->subControlRect(QStyle::CC_Slider, &option, QStyle::SC_SliderHandle, this);
+
+	// The handle's center moves from the groove's left + half the handle to the
+	// groove's right - half the handle
+	return QStyle::sliderValueFromPosition(minimum(), maximum(),
+	                                       x - groove.x() - handle.width() / 2,
+	                                       groove.width() - handle.width(), option.upsideDown);
+}
+
+void SeekBar::showPreview(int position, int x) {
+	QImage frame = preview->frameAt(position);
+	if(frame.isNull()) {
+		return;
+	}
+
+	QPixmap pixmap = QPixmap::fromImage(frame);
+	QPainter painter(&pixmap);
+	painter.setPen(Qt::white);
+	painter.drawText(pixmap.rect().adjusted(0, 0, 0, -2), Qt::AlignHCenter | Qt::AlignBottom,
+	                 QTime(0, 0, 0, 0).addMSecs(position).toString("HH:mm:ss.zzz"));
+	painter.end();
+
+	previewLabel.setPixmap(pixmap);
+	previewLabel.resize(pixmap.size());
+
+	QPoint topLeft = mapToGlobal(QPoint(x - pixmap.width() / 2, -pixmap.height() - 4));
+	previewLabel.move(topLeft);
+	previewLabel.show();
+	previewLabel.raise();
+}
@@ -0,0 +1,85 @@
+#pragma once
+
+#include "seekpreview.hpp"
+
+#include <QSlider>
+
+#include <QLabel>
+
+/*! \brief Seek bar of the video player, with a preview of the positions.
+ *
+ * Shows the frame under the mouse while hovering or dragging. When a preview
+ * is available, dragging does not seek the player: the position is only
+ * applied when the bar is released.
+ */
+class SeekBar : public QSlider {
+
+	Q_OBJECT
+
+public:
+	/*! \brief SeekBar constructor.
+	 *
+	 * \param parent the parent widget.
+	 */
+	explicit SeekBar(QWidget* parent = nullptr);
+
+	/*! \brief Set the preview shown while hovering or dragging.
+	 *
+	 * \param preview the preview, nullptr to show none.
+	 */
+	void setPreview(SeekPreview const* preview);
+
+signals:
+	/*! \brief Emitted while dragging if there is no preview.
+	 *
+	 * \param position the position in msecs.
+	 */
+	void scrubbed(int position);
+
+	/*! \brief Emitted when the bar is released after dragging.
+	 *
+	 * \param position the position in msecs.
+	 */
+	void scrubFinished(int position);
+
+protected slots:
+	/*! \brief Show the preview of the dragged position, or forward it.
+	 *
+	 * \param position the position in msecs.
+	 */
+	void handleSliderMoved(int position);
+
+	/*! \brief Hide the preview and emit scrubFinished.
+	 */
+	void handleSliderReleased();
+
+protected:
+	/*! \brief Show the preview of the position under the mouse.
+	 *
+	 * \param event the mouse event.
+	 */
+	virtual void mouseMoveEvent(QMouseEvent* event) override;
+
+	/*! \brief Hide the preview when the mouse leaves the bar.
+	 *
+	 * \param event the event.
+	 */
+	virtual void leaveEvent(QEvent* event) override;
+
+	/*! \brief Get the position under a horizontal coordinate.
+	 *
+	 * \param x the coordinate relative to the bar.
+	 * \return the position in msecs.
+	 */
+	int positionAt(int x) const;
+
+	/*! \brief Show the preview of a position above the bar.
+	 *
+	 * \param position the position in msecs.
+	 * \param x the horizontal coordinate where to show it, relative to the bar.
+	 */
+	void showPreview(int position, int x);
+
+	SeekPreview const* preview = nullptr;
+	QLabel previewLabel;
+};
@@ -0,0 +1,109 @@
+#include "seekpreview.hpp"
+
+#include "timelinedecoder.hpp"
+
+#include <QtConcurrent>
+
+#include <algorithm>
+#include <exception>
+
+SeekPreview::SeekPreview(QObject* parent)
+      : QObject(parent)
+      , generation(0) {}
+
+SeekPreview::~SeekPreview() {
+	++generation;
+	sampling.waitForFinished();
+}
+
+void SeekPreview::setTimeline(Timeline const& timeline) {
+	quint64 current = ++generation;
+	// Stops at the next sample
+	sampling.waitForFinished();
+	interval = 0;
+	samples.clear();
+	sampled = 0;
+
+	sampling = QtConcurrent::run([this, timeline, current]() { sample(timeline, current); });
+}
+
+bool SeekPreview::isAvailable() const {
+	return sampled > 0;
+}
+
+QImage SeekPreview::frameAt(qint64 position) const {
+	if(sampled == 0) {
+		return QImage();
+	}
+
+	// Look for the closest sample, in both directions
+	int count = samples.size();
+	int index = std::min(std::max(static_cast<int>((position + interval / 2) / interval), 0), count - 1);
+	for(int distance = 0 ; distance < count ; ++distance) {
+		if(index - distance >= 0 && !samples[index - distance].isNull()) {
+			return samples[index - distance];
+		} else if(index + distance < count && !samples[index + distance].isNull()) {
+			return samples[index + distance];
+		}
+	}
+	return QImage();
+}
+
+void SeekPreview::initializeSamples(quint64 generation, qint64 interval, int count) {
+	if(generation != this->generation) {
+		return;
+	}
+	this->interval = interval;
+	samples.assign(count, QImage());
+}
+
+void SeekPreview::storeSample(quint64 generation, int index, QImage const& frame) {
+	if(generation != this->generation || index >= static_cast<int>(samples.size())) {
+		return;
+	}
+	if(samples[index].isNull() && !frame.isNull()) {
+		++sampled;
+	}
+	samples[index] = frame;
+}
+
+void SeekPreview::sample(Timeline const& timeline, quint64 generation) {
+	try {
+		TimelineDecoder decoder(timeline);
+		decoder.setFastDecoding(true);
+
+		qint64 duration = decoder.getDuration();
+		int count = std::max(std::min<qint64>(duration / minInterval, maxSamples), qint64(1));
+		qint64 interval = std::max<qint64>(duration / count, 1);
+
+		QMetaObject::invokeMethod(this, "initializeSamples", Qt::QueuedConnection,
+		                          Q_ARG(quint64, generation), Q_ARG(qint64, interval),
+		                          Q_ARG(int, count));
+
+		// Coarse to fine: every 2^k-th sample, then the ones in between, etc.
+		int stride = 1;
+		while(stride * 2 < count) {
+			stride *= 2;
+		}
+		for(bool firstPass = true ; stride > 0 ; stride /= 2, firstPass = false) {
+			// After the first pass, the even multiples of the stride are sampled
+			int first = firstPass ? 0 : stride;
+			int step = firstPass ? stride : stride * 2;
+			for(int index = first ; index < count ; index += step) {
+				if(this->generation != generation) {
+					return;
+				}
+
+				QImage frame;
+				if(decoder.decodeFrameAt(index * interval)) {
+					frame = decoder.getFrameImage(frameSize);
+				}
+				QMetaObject::invokeMethod(this, "storeSample", Qt::QueuedConnection,
+				                          Q_ARG(quint64, generation), Q_ARG(int, index),
+				                          Q_ARG(QImage, frame));
+			}
+		}
+	} catch(std::exception const&) {
+		// No preview, the seek bar will seek the player instead
+	}
+}
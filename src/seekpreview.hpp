@@ -0,0 +1,92 @@
+#pragma once
+
+#include "timeline.hpp"
+
+#include <QObject>
+
+#include <QFuture>
+#include <QImage>
+#include <QSize>
+#include <QString>
+
+#include <atomic>
+#include <vector>
+
+/*! \brief Sparse index of low resolution frames of the clips of a project.
+ *
+ * Used to preview positions while hovering or dragging the seek bar, without
+ * seeking the player. The frames are sampled at a regular interval in the
+ * background, coarse to fine, so the whole video is quickly covered and the
+ * preview gets more precise as the sampling goes.
+ */
+class SeekPreview : public QObject {
+
+	Q_OBJECT
+
+public:
+	/*! \brief SeekPreview constructor.
+	 *
+	 * \param parent the parent QObject.
+	 */
+	explicit SeekPreview(QObject* parent = nullptr);
+
+	/*! \brief SeekPreview destructor.
+	 *
+	 * Stops the sampling.
+	 */
+	~SeekPreview();
+
+	/*! \brief Start sampling the clips of a project.
+	 *
+	 * Drops the samples of the previous clips.
+	 *
+	 * \param timeline the clips of the project.
+	 */
+	void setTimeline(Timeline const& timeline);
+
+	/*! \brief Returns true if at least one frame was sampled.
+	 */
+	bool isAvailable() const;
+
+	/*! \brief Get the sampled frame closest to a position.
+	 *
+	 * \param position the position in msecs.
+	 * \return the frame, or a null image if nothing was sampled yet.
+	 */
+	QImage frameAt(qint64 position) const;
+
+protected slots:
+	/*! \brief Prepare the storage of the samples.
+	 *
+	 * \param generation the generation of the sampled video.
+	 * \param interval the duration between two samples in msecs.
+	 * \param count the number of samples.
+	 */
+	void initializeSamples(quint64 generation, qint64 interval, int count);
+
+	/*! \brief Store a sample made in the background.
+	 *
+	 * \param generation the generation of the sampled video.
+	 * \param index the index of the sample.
+	 * \param frame the sampled frame.
+	 */
+	void storeSample(quint64 generation, int index, QImage const& frame);
+
+protected:
+	/*! \brief Sample the clips of a project.
+	 *
+	 * Runs in the background until the generation changes.
+	 */
+	void sample(Timeline const& timeline, quint64 generation);
+
+	QSize frameSize = QSize(160, 90);
+	qint64 minInterval = 1'000;
+	int maxSamples = 600;
+
+	qint64 interval = 0;
+	std::vector<QImage> samples;
+	int sampled = 0;
+
+	std::atomic<quint64> generation;
+	QFuture<void> sampling;
+};
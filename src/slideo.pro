@@ -1,10 +1,10 @@
-QT  += core gui widgets multimedia multimediawidgets
+QT  += core gui widgets multimedia multimediawidgets concurrent
 
 CONFIG += c++14 link_pkgconfig
-PKGCONFIG += yaml-cpp
+PKGCONFIG += yaml-cpp libavformat libavcodec libavutil libswscale
 
 TARGET = slideo
 TEMPLATE = app
 
-SOURCES += mainwindow.cpp videoplayermanager.cpp projectmanager.cpp timeselectdialog.cpp doubleclickablelabel.cpp history.cpp addbreakpointregularlydialog.cpp main.cpp
-HEADERS += mainwindow.hpp videoplayermanager.hpp projectmanager.hpp timeselectdialog.hpp doubleclickablelabel.hpp history.hpp addbreakpointregularlydialog.hpp
+SOURCES += mainwindow.cpp videoplayermanager.cpp projectmanager.cpp timeselectdialog.cpp doubleclickablelabel.cpp history.cpp addbreakpointregularlydialog.cpp breakpointset.cpp breakpointlistmodel.cpp breakpointsfile.cpp autosave.cpp videodecoder.cpp timeline.cpp timelinedecoder.cpp framecache.cpp keyframeindex.cpp scenedetector.cpp detectslidechangesdialog.cpp thumbnailprovider.cpp seekpreview.cpp seekbar.cpp videoframefanout.cpp presenterconsole.cpp projectlibrary.cpp projectlibrarydialog.cpp batch.cpp main.cpp
+HEADERS += mainwindow.hpp videoplayermanager.hpp projectmanager.hpp timeselectdialog.hpp doubleclickablelabel.hpp history.hpp addbreakpointregularlydialog.hpp breakpointset.hpp breakpointlistmodel.hpp breakpointsfile.hpp autosave.hpp videodecoder.hpp timeline.hpp timelinedecoder.hpp framecache.hpp keyframeindex.hpp scenedetector.hpp detectslidechangesdialog.hpp thumbnailprovider.hpp seekpreview.hpp seekbar.hpp videoframefanout.hpp presenterconsole.hpp projectlibrary.hpp projectlibrarydialog.hpp batch.hpp
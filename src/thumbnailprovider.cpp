@@ -0,0 +1,212 @@
+#include "thumbnailprovider.hpp"
+
+#include "timelinedecoder.hpp"
+
+#include <QCryptographicHash>
+#include <QDateTime>
+#include <QDir>
+#include <QDirIterator>
+#include <QFile>
+#include <QFileInfo>
+#include <QMutexLocker>
+#include <QStandardPaths>
+
+#include <QtConcurrent>
+
+#include <algorithm>
+#include <exception>
+#include <memory>
+
+namespace {
+	QString cacheRoot() {
+		return QDir(QStandardPaths::writableLocation(QStandardPaths::CacheLocation))
+		  .filePath("thumbnails");
+	}
+}
+
+ThumbnailProvider::ThumbnailProvider(QObject* parent)
+      : QObject(parent)
+      , thumbnails(16 * 1024) {
+	// Leave some cores for the player
+	pool.setMaxThreadCount(std::max(QThread::idealThreadCount() / 2, 1));
+}
+
+ThumbnailProvider::~ThumbnailProvider() {
+	{
+		QMutexLocker lock(&mutex);
+		pending.clear();
+		++generation;
+	}
+	pool.waitForDone();
+}
+
+void ThumbnailProvider::setTimeline(Timeline const& timeline) {
+	QString cacheDir = cacheDirectory(timeline);
+	QDir().mkpath(cacheDir);
+
+	QMutexLocker lock(&mutex);
+	this->timeline = timeline;
+	this->cacheDir = cacheDir;
+	++generation;
+	pending.clear();
+	requested.clear();
+	thumbnails.clear();
+
+	// The other videos might have filled the cache since
+	startPruning();
+}
+
+QSize ThumbnailProvider::getThumbnailSize() const {
+	return thumbnailSize;
+}
+
+QImage ThumbnailProvider::thumbnail(qint64 position) {
+	if(QImage* image = thumbnails.object(position)) {
+		return *image;
+	}
+
+	QMutexLocker lock(&mutex);
+	if(timeline.empty() || requested.count(position)) {
+		return QImage();
+	}
+
+	pending.push_front(position);
+	requested.insert(position);
+	if(pending.size() > maxPending) {
+		// Probably scrolled away, will be requested again if needed
+		requested.erase(pending.back());
+		pending.pop_back();
+	}
+
+	startWorkers();
+	return QImage();
+}
+
+QString ThumbnailProvider::cacheDirectory(Timeline const& timeline) {
+	// Hashing the whole videos would be too slow, their size and their
+	// beginning are enough to tell videos apart
+	QCryptographicHash hash(QCryptographicHash::Sha1);
+	for(std::size_t i = 0 ; i < timeline.size() ; ++i) {
+		QFile file(timeline.at(i).file);
+		hash.addData(QByteArray::number(file.size()));
+		if(file.open(QIODevice::ReadOnly)) {
+			hash.addData(file.read(1024 * 1024));
+		}
+	}
+
+	return QDir(cacheRoot()).filePath(hash.result().toHex());
+}
+
+void ThumbnailProvider::pruneDiskCache(qint64 budget) {
+	QFileInfoList files;
+	qint64 size = 0;
+	QDirIterator it(cacheRoot(), QStringList{"*.jpg"}, QDir::Files, QDirIterator::Subdirectories);
+	while(it.hasNext()) {
+		it.next();
+		files.append(it.fileInfo());
+		size += it.fileInfo().size();
+	}
+	if(size <= budget) {
+		return;
+	}
+
+	std::sort(files.begin(), files.end(), [](QFileInfo const& a, QFileInfo const& b) {
+		return a.lastModified() < b.lastModified();
+	});
+	for(QFileInfo const& file : files) {
+		if(size <= budget) {
+			break;
+		}
+		if(QFile::remove(file.filePath())) {
+			size -= file.size();
+		}
+	}
+}
+
+void ThumbnailProvider::storeThumbnail(quint64 generation, qint64 position,
+                                       QImage const& thumbnail) {
+	{
+		QMutexLocker lock(&mutex);
+		if(generation != this->generation) {
+			return;
+		}
+		requested.erase(position);
+	}
+
+	if(!thumbnail.isNull()) {
+		int cost = std::max(static_cast<int>(thumbnail.sizeInBytes() / 1024), 1);
+		thumbnails.insert(position, new QImage(thumbnail), cost);
+		emit thumbnailReady(position);
+	}
+}
+
+void ThumbnailProvider::startWorkers() {
+	while(workers < pool.maxThreadCount() && static_cast<std::size_t>(workers) < pending.size()) {
+		++workers;
+		QtConcurrent::run(&pool, [this]() { work(); });
+	}
+}
+
+void ThumbnailProvider::startPruning() {
+	diskCacheWritten = 0;
+	QtConcurrent::run(&pool, [budget = diskCacheBudget]() { pruneDiskCache(budget); });
+}
+
+void ThumbnailProvider::work() {
+	std::unique_ptr<TimelineDecoder> decoder;
+	quint64 decoderGeneration = 0;
+
+	while(true) {
+		Timeline timeline;
+		QString cacheDir;
+		quint64 generation;
+		qint64 position;
+		{
+			QMutexLocker lock(&mutex);
+			if(pending.empty()) {
+				--workers;
+				return;
+			}
+			position = pending.front();
+			pending.pop_front();
+			timeline = this->timeline;
+			cacheDir = this->cacheDir;
+			generation = this->generation;
+		}
+
+		QString cacheFile = QDir(cacheDir).filePath(QString::number(position) + ".jpg");
+		QImage image(cacheFile);
+
+		if(!image.isNull()) {
+			// Most recently used, see pruneDiskCache
+			QFile file(cacheFile);
+			if(file.open(QIODevice::Append)) {
+				file.setFileTime(QDateTime::currentDateTime(), QFileDevice::FileModificationTime);
+			}
+		} else {
+			try {
+				if(!decoder || decoderGeneration != generation) {
+					decoder.reset(new TimelineDecoder(timeline));
+					decoderGeneration = generation;
+				}
+				if(decoder->decodeFrameAt(position)) {
+					image = decoder->getFrameImage(thumbnailSize);
+					if(image.save(cacheFile, "JPG", 85)) {
+						QMutexLocker lock(&mutex);
+						diskCacheWritten += QFileInfo(cacheFile).size();
+						if(diskCacheWritten > diskCacheBudget / 4) {
+							startPruning();
+						}
+					}
+				}
+			} catch(std::exception const&) {
+				// Retried with a new decoder if requested again
+				decoder.reset();
+			}
+		}
+
+		QMetaObject::invokeMethod(this, "storeThumbnail", Qt::QueuedConnection,
+		                          Q_ARG(quint64, generation), Q_ARG(qint64, position),
+		                          Q_ARG(QImage, image));
+	}
+}
@@ -0,0 +1,144 @@
+#pragma once
+
+#include "timeline.hpp"
+
+#include <QObject>
+
+#include <QCache>
+#include <QImage>
+#include <QMutex>
+#include <QSize>
+#include <QString>
+#include <QThreadPool>
+
+#include <deque>
+#include <set>
+
+/*! \brief Class providing the thumbnails of the breakpoints.
+ *
+ * Thumbnails are generated on demand by a pool of workers, each with its own
+ * TimelineDecoder, and stored in an on-disk cache (in the user's cache
+ * directory) keyed by a hash of the clips and the position. The on-disk cache
+ * of all the videos is bounded, the least recently used thumbnails being
+ * removed. The most recently used thumbnails are also kept in memory.
+ */
+class ThumbnailProvider : public QObject {
+
+	Q_OBJECT
+
+public:
+	/*! \brief ThumbnailProvider constructor.
+	 *
+	 * \param parent the parent QObject.
+	 */
+	explicit ThumbnailProvider(QObject* parent = nullptr);
+
+	/*! \brief ThumbnailProvider destructor.
+	 *
+	 * Waits for the workers.
+	 */
+	~ThumbnailProvider();
+
+	/*! \brief Set the clips to generate the thumbnails from.
+	 *
+	 * Drops the pending requests and the thumbnails kept in memory.
+	 *
+	 * \param timeline the clips of the project.
+	 */
+	void setTimeline(Timeline const& timeline);
+
+	/*! \brief Get the size of the thumbnails.
+	 */
+	QSize getThumbnailSize() const;
+
+	/*! \brief Get the thumbnail at a position.
+	 *
+	 * If it is not in memory, it is requested and thumbnailReady will be
+	 * emitted once it is available.
+	 *
+	 * \param position the position in msecs.
+	 * \return the thumbnail, or a null image if it is not available yet.
+	 */
+	QImage thumbnail(qint64 position);
+
+	/*! \brief Get the path of the on-disk cache of a timeline.
+	 *
+	 * \param timeline the clips of the project.
+	 * \return the path of the cache directory.
+	 */
+	static QString cacheDirectory(Timeline const& timeline);
+
+	/*! \brief Remove the least recently used thumbnails of the on-disk cache.
+	 *
+	 * The thumbnails are ordered by modification time, which is updated when
+	 * they are read from the cache.
+	 *
+	 * \param budget the maximum size of the cache of all the videos, in bytes.
+	 */
+	static void pruneDiskCache(qint64 budget);
+
+signals:
+	/*! \brief Emitted when a requested thumbnail is available.
+	 *
+	 * \param position the position of the thumbnail in msecs.
+	 */
+	void thumbnailReady(qint64 position);
+
+protected slots:
+	/*! \brief Store a thumbnail made by a worker.
+	 *
+	 * \param generation the generation of the video of the thumbnail.
+	 * \param position the position of the thumbnail.
+	 * \param thumbnail the thumbnail.
+	 */
+	void storeThumbnail(quint64 generation, qint64 position, QImage const& thumbnail);
+
+protected:
+	/*! \brief Start workers until all the pending requests are handled.
+	 *
+	 * Must be called with the mutex locked.
+	 */
+	void startWorkers();
+
+	/*! \brief Handle pending requests until there is none left.
+	 *
+	 * Runs in the thread pool.
+	 */
+	void work();
+
+	/*! \brief Run pruneDiskCache in the thread pool.
+	 *
+	 * Must be called with the mutex locked.
+	 */
+	void startPruning();
+
+	QSize thumbnailSize = QSize(160, 90);
+
+	/*! \brief The thumbnails in memory, the cost being their size in KiB.
+	 */
+	QCache<qint64, QImage> thumbnails;
+
+	/*! \brief Requests not handled yet, the most recent first.
+	 *
+	 * The views request the visible rows, so the most recent requests are the
+	 * most useful ones.
+	 */
+	std::deque<qint64> pending;
+	std::set<qint64> requested;
+	std::size_t maxPending = 512;
+
+	/*! \brief Maximum size of the on-disk cache, in bytes.
+	 */
+	qint64 diskCacheBudget = 256 * 1024 * 1024;
+
+	// Protects the following attributes, shared with the workers
+	QMutex mutex;
+	Timeline timeline;
+	QString cacheDir;
+	quint64 generation = 0;
+	int workers = 0;
+	// Written to the on-disk cache since it was last pruned, in bytes
+	qint64 diskCacheWritten = 0;
+
+	QThreadPool pool;
+};
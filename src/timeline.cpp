@@ -0,0 +1,49 @@
+#include "timeline.hpp"
+
+#include <algorithm>
+
+void Timeline::append(QString const& file, qint64 duration) {
+	clips.push_back({file, getDuration(), duration});
+}
+
+void Timeline::setDuration(std::size_t index, qint64 duration) {
+	qint64 shift = duration - clips[index].duration;
+	clips[index].duration = duration;
+	for(std::size_t i = index + 1 ; i < clips.size() ; ++i) {
+		clips[i].offset += shift;
+	}
+}
+
+bool Timeline::empty() const {
+	return clips.empty();
+}
+
+std::size_t Timeline::size() const {
+	return clips.size();
+}
+
+Timeline::Clip const& Timeline::at(std::size_t index) const {
+	return clips[index];
+}
+
+std::size_t Timeline::clipAt(qint64 position) const {
+	// The last clip beginning before the position
+	auto it = std::upper_bound(clips.cbegin(), clips.cend(), position,
+	                           [](qint64 position, Clip const& clip) { return position < clip.offset; });
+	return (it == clips.cbegin()) ? 0 : (it - clips.cbegin()) - 1;
+}
+
+qint64 Timeline::getDuration() const {
+	return clips.empty() ? 0 : clips.back().offset + clips.back().duration;
+}
+
+bool Timeline::operator==(Timeline const& other) const {
+	return std::equal(clips.cbegin(), clips.cend(), other.clips.cbegin(), other.clips.cend(),
+	                  [](Clip const& a, Clip const& b) {
+		                  return a.file == b.file && a.offset == b.offset && a.duration == b.duration;
+	                  });
+}
+
+bool Timeline::operator!=(Timeline const& other) const {
+	return !(*this == other);
+}
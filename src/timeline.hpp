@@ -0,0 +1,80 @@
+#pragma once
+
+#include <QString>
+
+#include <vector>
+
+/*! \brief The video clips of a project, played one after the other.
+ *
+ * Positions on the timeline are in msecs from the beginning of the first
+ * clip, the breakpoints of a project are stored as timeline positions.
+ */
+class Timeline {
+public:
+	/*! \brief A video clip and its place on the timeline.
+	 */
+	struct Clip {
+		//! The path of the video file.
+		QString file;
+		//! The position of the beginning of the clip on the timeline.
+		qint64 offset;
+		//! The duration of the clip in msecs, 0 if unknown.
+		qint64 duration;
+	};
+
+	/*! \brief Timeline default constructor.
+	 *
+	 * Constructs an empty timeline.
+	 */
+	Timeline() = default;
+
+	/*! \brief Add a clip at the end of the timeline.
+	 *
+	 * \param file the path of the video file.
+	 * \param duration the duration of the clip in msecs, 0 if unknown.
+	 */
+	void append(QString const& file, qint64 duration);
+
+	/*! \brief Set the duration of a clip.
+	 *
+	 * The clips after it are moved accordingly.
+	 *
+	 * \param index the index of the clip.
+	 * \param duration the duration in msecs.
+	 */
+	void setDuration(std::size_t index, qint64 duration);
+
+	/*! \brief Returns true if there is no clip.
+	 */
+	bool empty() const;
+
+	/*! \brief Get the number of clips.
+	 */
+	std::size_t size() const;
+
+	/*! \brief Get a clip.
+	 *
+	 * \param index the index of the clip, must be lower than size().
+	 * \return the clip.
+	 */
+	Clip const& at(std::size_t index) const;
+
+	/*! \brief Get the clip playing at a position.
+	 *
+	 * \param position the position on the timeline in msecs.
+	 * \return the index of the clip, 0 if the timeline is empty.
+	 */
+	std::size_t clipAt(qint64 position) const;
+
+	/*! \brief Get the duration of the whole timeline in msecs.
+	 *
+	 * Only valid if the duration of every clip is known.
+	 */
+	qint64 getDuration() const;
+
+	bool operator==(Timeline const& other) const;
+	bool operator!=(Timeline const& other) const;
+
+protected:
+	std::vector<Clip> clips;
+};
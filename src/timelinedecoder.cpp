@@ -0,0 +1,91 @@
+#include "timelinedecoder.hpp"
+
+#include <stdexcept>
+
+TimelineDecoder::TimelineDecoder(Timeline timeline, int threads)
+      : timeline(std::move(timeline))
+      , threads(threads) {
+	if(this->timeline.empty()) {
+		throw std::runtime_error("No video clip");
+	}
+
+	for(std::size_t i = 0 ; i < this->timeline.size() ; ++i) {
+		if(this->timeline.at(i).duration <= 0) {
+			openClip(i);
+			this->timeline.setDuration(i, decoder->getDuration());
+		}
+	}
+	openClip(0);
+}
+
+Timeline const& TimelineDecoder::getTimeline() const {
+	return timeline;
+}
+
+qint64 TimelineDecoder::getDuration() const {
+	return timeline.getDuration();
+}
+
+bool TimelineDecoder::decodeNextFrame() {
+	while(!decoder->decodeNextFrame()) {
+		if(clipIndex + 1 >= timeline.size()) {
+			return false;
+		}
+		// A newly opened clip is decoded from its beginning
+		openClip(clipIndex + 1);
+	}
+	return true;
+}
+
+bool TimelineDecoder::decodeFrameAt(qint64 position) {
+	openClip(timeline.clipAt(position));
+	return decoder->decodeFrameAt(position - timeline.at(clipIndex).offset);
+}
+
+qint64 TimelineDecoder::getFramePosition() const {
+	return timeline.at(clipIndex).offset + decoder->getFramePosition();
+}
+
+QImage TimelineDecoder::getFrameImage(QSize size) {
+	return decoder->getFrameImage(size);
+}
+
+bool TimelineDecoder::getFrameLuma(QSize size, std::vector<uchar>& luma) {
+	return decoder->getFrameLuma(size, luma);
+}
+
+void TimelineDecoder::setFastDecoding(bool fast) {
+	this->fast = fast;
+	decoder->setFastDecoding(fast);
+}
+
+std::vector<qint64> TimelineDecoder::scanKeyframes(qint64& frameCount) {
+	std::vector<qint64> keyframes;
+	frameCount = 0;
+	for(std::size_t i = 0 ; i < timeline.size() ; ++i) {
+		// Reopened so the whole clip is scanned
+		decoder.reset();
+		openClip(i);
+
+		qint64 clipFrameCount = 0;
+		qint64 offset = timeline.at(i).offset;
+		keyframes.push_back(offset);
+		for(qint64 keyframe : decoder->scanKeyframes(clipFrameCount)) {
+			if(keyframe > 0) {
+				keyframes.push_back(offset + keyframe);
+			}
+		}
+		frameCount += clipFrameCount;
+	}
+	return keyframes;
+}
+
+void TimelineDecoder::openClip(std::size_t index) {
+	if(decoder && index == clipIndex) {
+		return;
+	}
+
+	decoder.reset(new VideoDecoder(timeline.at(index).file, threads));
+	decoder->setFastDecoding(fast);
+	clipIndex = index;
+}
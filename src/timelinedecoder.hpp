@@ -0,0 +1,98 @@
+#pragma once
+
+#include "timeline.hpp"
+#include "videodecoder.hpp"
+
+#include <QImage>
+#include <QSize>
+
+#include <memory>
+#include <vector>
+
+/*! \brief Class used to decode frames of a timeline outside of the player.
+ *
+ * Same interface as VideoDecoder, with positions on the timeline. Only the
+ * clip being decoded is kept open, decoding goes on into the next clip at the
+ * end of a clip. A TimelineDecoder must only be used by one thread at a time.
+ */
+class TimelineDecoder {
+public:
+	/*! \brief TimelineDecoder constructor.
+	 *
+	 * Opens the first clip, and the clips of unknown duration to get their
+	 * duration. Throws std::runtime_error if a clip cannot be opened or if
+	 * the timeline is empty.
+	 *
+	 * \param timeline the clips to decode.
+	 * \param threads the number of decoding threads, 0 to let FFmpeg decide.
+	 */
+	explicit TimelineDecoder(Timeline timeline, int threads = 1);
+
+	/*! \brief Get the timeline, with the duration of every clip known.
+	 */
+	Timeline const& getTimeline() const;
+
+	/*! \brief Get the duration of the timeline in msecs.
+	 */
+	qint64 getDuration() const;
+
+	/*! \brief Decode the next frame, continuing into the next clip.
+	 *
+	 * \return false at the end of the last clip or on error.
+	 */
+	bool decodeNextFrame();
+
+	/*! \brief Decode frames until the one displayed at the given position.
+	 *
+	 * See VideoDecoder::decodeFrameAt.
+	 *
+	 * \param position the position on the timeline in msecs.
+	 * \return false if there is no such frame.
+	 */
+	bool decodeFrameAt(qint64 position);
+
+	/*! \brief Get the position of the last decoded frame on the timeline.
+	 */
+	qint64 getFramePosition() const;
+
+	/*! \brief Convert the last decoded frame to an image.
+	 *
+	 * See VideoDecoder::getFrameImage.
+	 */
+	QImage getFrameImage(QSize size = QSize());
+
+	/*! \brief Convert the last decoded frame to a grayscale buffer.
+	 *
+	 * See VideoDecoder::getFrameLuma.
+	 */
+	bool getFrameLuma(QSize size, std::vector<uchar>& luma);
+
+	/*! \brief Trade the quality of the decoded frames for speed.
+	 *
+	 * See VideoDecoder::setFastDecoding.
+	 */
+	void setFastDecoding(bool fast);
+
+	/*! \brief Find the keyframes of every clip without decoding them.
+	 *
+	 * The beginning of each clip is a keyframe.
+	 *
+	 * \param frameCount set to the number of frames read.
+	 * \return the positions of the keyframes on the timeline, sorted.
+	 */
+	std::vector<qint64> scanKeyframes(qint64& frameCount);
+
+protected:
+	/*! \brief Open a clip, if it is not the current one.
+	 *
+	 * \param index the index of the clip.
+	 */
+	void openClip(std::size_t index);
+
+	Timeline timeline;
+	int threads;
+	bool fast = false;
+
+	std::size_t clipIndex = 0;
+	std::unique_ptr<VideoDecoder> decoder;
+};
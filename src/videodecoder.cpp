@@ -0,0 +1,259 @@
+#include "videodecoder.hpp"
+
+extern "C" {
+#include <libavcodec/avcodec.h>
+#include <libavformat/avformat.h>
+#include <libavutil/imgutils.h>
+#include <libswscale/swscale.h>
+}
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace {
+	AVRational const msecsTimeBase = {1, 1'000};
+
+	// AVFrame::pkt_duration was deprecated for AVFrame::duration, then removed
+	int64_t getFrameDuration(AVFrame const* frame) {
+#if LIBAVUTIL_VERSION_INT >= AV_VERSION_INT(58, 2, 100)
+		return frame->duration;
+#else
+		return frame->pkt_duration;
+#endif
+	}
+}
+
+VideoDecoder::VideoDecoder(QString const& videoFile, int threads) {
+	if(avformat_open_input(&format, videoFile.toUtf8().constData(), nullptr, nullptr) < 0) {
+		throw std::runtime_error("Could not open " + videoFile.toStdString());
+	}
+
+	// av_find_best_stream takes a const decoder since FFmpeg 5
+#if LIBAVFORMAT_VERSION_MAJOR < 59
+	AVCodec* decoder = nullptr;
+#else
+	AVCodec const* decoder = nullptr;
+#endif
+	if(avformat_find_stream_info(format, nullptr) < 0 ||
+	   (streamIndex = av_find_best_stream(format, AVMEDIA_TYPE_VIDEO, -1, -1, &decoder, 0)) < 0) {
+		avformat_close_input(&format);
+		throw std::runtime_error("No video stream in " + videoFile.toStdString());
+	}
+
+	codec = avcodec_alloc_context3(decoder);
+	codec->thread_count = threads;
+	if(avcodec_parameters_to_context(codec, format->streams[streamIndex]->codecpar) < 0 ||
+	   avcodec_open2(codec, decoder, nullptr) < 0) {
+		avcodec_free_context(&codec);
+		avformat_close_input(&format);
+		throw std::runtime_error("Could not decode the video stream of " + videoFile.toStdString());
+	}
+
+	// Only the video stream is needed
+	for(unsigned int i = 0 ; i < format->nb_streams ; ++i) {
+		if(static_cast<int>(i) != streamIndex) {
+			format->streams[i]->discard = AVDISCARD_ALL;
+		}
+	}
+
+	frame = av_frame_alloc();
+	packet = av_packet_alloc();
+}
+
+VideoDecoder::~VideoDecoder() {
+	sws_freeContext(scaler);
+	sws_freeContext(lumaScaler);
+	av_packet_free(&packet);
+	av_frame_free(&frame);
+	avcodec_free_context(&codec);
+	avformat_close_input(&format);
+}
+
+qint64 VideoDecoder::getDuration() const {
+	if(format->duration == AV_NOPTS_VALUE) {
+		return 0;
+	}
+	return av_rescale_q(format->duration, AV_TIME_BASE_Q, msecsTimeBase);
+}
+
+QSize VideoDecoder::getFrameSize() const {
+	return QSize(codec->width, codec->height);
+}
+
+bool VideoDecoder::seek(qint64 position) {
+	AVStream* stream = format->streams[streamIndex];
+	qint64 timestamp = av_rescale_q(position, msecsTimeBase, stream->time_base);
+	if(stream->start_time != AV_NOPTS_VALUE) {
+		timestamp += stream->start_time;
+	}
+
+	if(av_seek_frame(format, streamIndex, timestamp, AVSEEK_FLAG_BACKWARD) < 0) {
+		return false;
+	}
+
+	avcodec_flush_buffers(codec);
+	draining = false;
+	framePosition = -1;
+	return true;
+}
+
+bool VideoDecoder::decodeNextFrame() {
+	while(true) {
+		int ret = avcodec_receive_frame(codec, frame);
+		if(ret == 0) {
+			AVStream* stream = format->streams[streamIndex];
+			qint64 timestamp = frame->best_effort_timestamp;
+			if(timestamp == AV_NOPTS_VALUE) {
+				timestamp = frame->pts;
+			}
+			if(stream->start_time != AV_NOPTS_VALUE) {
+				timestamp -= stream->start_time;
+			}
+			framePosition = av_rescale_q(timestamp, stream->time_base, msecsTimeBase);
+			return true;
+		} else if(ret == AVERROR_EOF || draining) {
+			return false;
+		} else if(ret != AVERROR(EAGAIN)) {
+			return false;
+		}
+
+		// The decoder needs more data
+		while(true) {
+			ret = av_read_frame(format, packet);
+			if(ret < 0) {
+				// End of file, get the remaining frames
+				avcodec_send_packet(codec, nullptr);
+				draining = true;
+				break;
+			}
+
+			bool isVideo = packet->stream_index == streamIndex;
+			if(isVideo) {
+				ret = avcodec_send_packet(codec, packet);
+			}
+			av_packet_unref(packet);
+
+			if(isVideo) {
+				if(ret < 0 && ret != AVERROR(EAGAIN)) {
+					return false;
+				}
+				break;
+			}
+		}
+	}
+}
+
+bool VideoDecoder::decodeFrameAt(qint64 position) {
+	bool decodeForward = framePosition >= 0 && position >= framePosition &&
+	                     position - framePosition <= maxDecodeForward;
+	if(decodeForward) {
+		qint64 frameDuration = av_rescale_q(getFrameDuration(frame),
+		                                    format->streams[streamIndex]->time_base, msecsTimeBase);
+		if(framePosition + frameDuration > position) {
+			// Already decoded
+			return true;
+		}
+	} else if(!seek(position)) {
+		return false;
+	}
+
+	while(decodeNextFrame()) {
+		// The frame displayed at position is the last one starting before it,
+		// approximated by the first one ending after it
+		qint64 frameDuration = av_rescale_q(getFrameDuration(frame),
+		                                    format->streams[streamIndex]->time_base, msecsTimeBase);
+		if(framePosition + frameDuration > position) {
+			return true;
+		}
+	}
+	return false;
+}
+
+qint64 VideoDecoder::getFramePosition() const {
+	return framePosition;
+}
+
+QImage VideoDecoder::getFrameImage(QSize size) {
+	if(framePosition < 0) {
+		return QImage();
+	}
+
+	QSize frameSize(frame->width, frame->height);
+	if(!size.isValid()) {
+		size = frameSize;
+	} else {
+		size = frameSize.scaled(size, Qt::KeepAspectRatio);
+	}
+
+	scaler = sws_getCachedContext(scaler, frame->width, frame->height,
+	                              static_cast<AVPixelFormat>(frame->format), size.width(),
+	                              size.height(), AV_PIX_FMT_RGB32, SWS_BILINEAR, nullptr, nullptr,
+	                              nullptr);
+	if(!scaler) {
+		return QImage();
+	}
+
+	QImage image(size, QImage::Format_RGB32);
+	uint8_t* destination[] = {image.bits()};
+	int destinationStride[] = {image.bytesPerLine()};
+	sws_scale(scaler, frame->data, frame->linesize, 0, frame->height, destination,
+	          destinationStride);
+	return image;
+}
+
+bool VideoDecoder::getFrameLuma(QSize size, std::vector<uchar>& luma) {
+	if(framePosition < 0) {
+		return false;
+	}
+
+	lumaScaler = sws_getCachedContext(lumaScaler, frame->width, frame->height,
+	                                  static_cast<AVPixelFormat>(frame->format), size.width(),
+	                                  size.height(), AV_PIX_FMT_GRAY8, SWS_FAST_BILINEAR, nullptr,
+	                                  nullptr, nullptr);
+	if(!lumaScaler) {
+		return false;
+	}
+
+	luma.resize(static_cast<std::size_t>(size.width()) * size.height());
+	uint8_t* destination[] = {luma.data()};
+	int destinationStride[] = {size.width()};
+	sws_scale(lumaScaler, frame->data, frame->linesize, 0, frame->height, destination,
+	          destinationStride);
+	return true;
+}
+
+void VideoDecoder::setFastDecoding(bool fast) {
+	codec->skip_loop_filter = fast ? AVDISCARD_ALL : AVDISCARD_DEFAULT;
+	if(fast) {
+		codec->flags2 |= AV_CODEC_FLAG2_FAST;
+	} else {
+		codec->flags2 &= ~AV_CODEC_FLAG2_FAST;
+	}
+}
+
+std::vector<qint64> VideoDecoder::scanKeyframes(qint64& frameCount) {
+	AVStream* stream = format->streams[streamIndex];
+	qint64 startTime = (stream->start_time != AV_NOPTS_VALUE) ? stream->start_time : 0;
+
+	std::vector<qint64> keyframes;
+	frameCount = 0;
+	while(av_read_frame(format, packet) >= 0) {
+		if(packet->stream_index == streamIndex) {
+			++frameCount;
+			if(packet->flags & AV_PKT_FLAG_KEY) {
+				qint64 timestamp = (packet->pts != AV_NOPTS_VALUE) ? packet->pts : packet->dts;
+				if(timestamp != AV_NOPTS_VALUE) {
+					keyframes.push_back(av_rescale_q(timestamp - startTime, stream->time_base, msecsTimeBase));
+				}
+			}
+		}
+		av_packet_unref(packet);
+	}
+
+	// Packets are in decoding order
+	std::sort(keyframes.begin(), keyframes.end());
+	keyframes.erase(std::unique(keyframes.begin(), keyframes.end()), keyframes.end());
+
+	framePosition = -1;
+	return keyframes;
+}
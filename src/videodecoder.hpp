@@ -0,0 +1,129 @@
+#pragma once
+
+#include <QImage>
+#include <QSize>
+#include <QString>
+
+#include <vector>
+
+struct AVFormatContext;
+struct AVCodecContext;
+struct AVFrame;
+struct AVPacket;
+struct SwsContext;
+
+/*! \brief Class used to decode frames of a video outside of the player.
+ *
+ * Wraps FFmpeg's demuxer and decoder for the best video stream of a file.
+ * A VideoDecoder must only be used by one thread at a time, but several
+ * decoders can be used in parallel.
+ */
+class VideoDecoder {
+public:
+	/*! \brief VideoDecoder constructor.
+	 *
+	 * Opens the video file. Throws std::runtime_error if the file cannot be
+	 * opened or has no decodable video stream.
+	 *
+	 * \param videoFile the path of the video file.
+	 * \param threads the number of decoding threads, 0 to let FFmpeg decide.
+	 */
+	explicit VideoDecoder(QString const& videoFile, int threads = 1);
+
+	VideoDecoder(VideoDecoder const&) = delete;
+	VideoDecoder& operator=(VideoDecoder const&) = delete;
+
+	~VideoDecoder();
+
+	/*! \brief Get the duration of the video in msecs.
+	 */
+	qint64 getDuration() const;
+
+	/*! \brief Get the size of the frames of the video.
+	 */
+	QSize getFrameSize() const;
+
+	/*! \brief Seek to the last keyframe before the given position.
+	 *
+	 * The next decoded frame will be this keyframe.
+	 *
+	 * \param position the position in msecs.
+	 * \return false if the seek failed.
+	 */
+	bool seek(qint64 position);
+
+	/*! \brief Decode the next frame.
+	 *
+	 * \return false at the end of the video or on error.
+	 */
+	bool decodeNextFrame();
+
+	/*! \brief Decode frames until the one displayed at the given position.
+	 *
+	 * Seeks to the previous keyframe first, unless the position is slightly
+	 * after the last decoded frame, in which case decoding simply goes on.
+	 *
+	 * \param position the position in msecs.
+	 * \return false if there is no such frame.
+	 */
+	bool decodeFrameAt(qint64 position);
+
+	/*! \brief Get the position of the last decoded frame in msecs.
+	 */
+	qint64 getFramePosition() const;
+
+	/*! \brief Convert the last decoded frame to an image.
+	 *
+	 * \param size the size of the image, the frame size if invalid. The aspect
+	 *        ratio is kept.
+	 * \return the image.
+	 */
+	QImage getFrameImage(QSize size = QSize());
+
+	/*! \brief Convert the last decoded frame to a grayscale buffer.
+	 *
+	 * Used for analysis, the aspect ratio is not kept.
+	 *
+	 * \param size the size of the buffer.
+	 * \param luma filled with size.width() * size.height() luma values, row
+	 *        by row.
+	 * \return false if there is no decoded frame.
+	 */
+	bool getFrameLuma(QSize size, std::vector<uchar>& luma);
+
+	/*! \brief Trade the quality of the decoded frames for speed.
+	 *
+	 * Skips the loop filter and allows non spec compliant speedups. Meant for
+	 * analysis of the frames, not for showing them.
+	 *
+	 * \param fast true to decode faster.
+	 */
+	void setFastDecoding(bool fast);
+
+	/*! \brief Find the keyframes of the video without decoding it.
+	 *
+	 * Only demuxes the video stream from the current position to the end, so
+	 * this is much faster than decoding. seek must be called before decoding
+	 * frames again.
+	 *
+	 * \param frameCount set to the number of frames read.
+	 * \return the positions of the keyframes in msecs, sorted.
+	 */
+	std::vector<qint64> scanKeyframes(qint64& frameCount);
+
+protected:
+	AVFormatContext* format = nullptr;
+	AVCodecContext* codec = nullptr;
+	AVFrame* frame = nullptr;
+	AVPacket* packet = nullptr;
+	SwsContext* scaler = nullptr;
+	SwsContext* lumaScaler = nullptr;
+	int streamIndex = -1;
+	qint64 framePosition = -1;
+	bool draining = false;
+
+	/*! \brief Distance (in msecs) under which decoding forward is assumed to
+	 * be cheaper than seeking.
+	 */
+	qint64 maxDecodeForward = 2'000;
+};
@@ -0,0 +1,66 @@
+#include "videoframefanout.hpp"
+
+#include <QVideoSurfaceFormat>
+
+#include <algorithm>
+
+VideoFrameFanout::VideoFrameFanout(QObject* parent)
+      : QAbstractVideoSurface(parent) {}
+
+void VideoFrameFanout::addSurface(QAbstractVideoSurface* surface) {
+	surfaces.push_back(surface);
+	if(isActive()) {
+		surface->start(surfaceFormat());
+	}
+}
+
+void VideoFrameFanout::removeSurface(QAbstractVideoSurface* surface) {
+	auto it = std::find(surfaces.begin(), surfaces.end(), surface);
+	if(it != surfaces.end()) {
+		if(surface->isActive()) {
+			surface->stop();
+		}
+		surfaces.erase(it);
+	}
+}
+
+QList<QVideoFrame::PixelFormat> VideoFrameFanout::supportedPixelFormats(
+  QAbstractVideoBuffer::HandleType type) const {
+	if(surfaces.empty()) {
+		return QList<QVideoFrame::PixelFormat>();
+	}
+	return surfaces.front()->supportedPixelFormats(type);
+}
+
+bool VideoFrameFanout::start(QVideoSurfaceFormat const& format) {
+	if(surfaces.empty() || !surfaces.front()->start(format)) {
+		return false;
+	}
+
+	// The other surfaces are optional
+	for(auto it = surfaces.begin() + 1 ; it != surfaces.end() ; ++it) {
+		(*it)->start(format);
+	}
+
+	return QAbstractVideoSurface::start(format);
+}
+
+void VideoFrameFanout::stop() {
+	for(QAbstractVideoSurface* surface : surfaces) {
+		surface->stop();
+	}
+	QAbstractVideoSurface::stop();
+}
+
+bool VideoFrameFanout::present(QVideoFrame const& frame) {
+	if(surfaces.empty() || !surfaces.front()->present(frame)) {
+		return false;
+	}
+
+	for(auto it = surfaces.begin() + 1 ; it != surfaces.end() ; ++it) {
+		if((*it)->isActive()) {
+			(*it)->present(frame);
+		}
+	}
+	return true;
+}
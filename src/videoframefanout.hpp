@@ -0,0 +1,46 @@
+#pragma once
+
+#include <QAbstractVideoSurface>
+
+#include <vector>
+
+/*! \brief Video surface forwarding the frames to several surfaces.
+ *
+ * QVideoFrame is implicitly shared, so the frames decoded once by a player
+ * are shown by several widgets without being copied.
+ */
+class VideoFrameFanout : public QAbstractVideoSurface {
+
+	Q_OBJECT
+
+public:
+	/*! \brief VideoFrameFanout constructor.
+	 *
+	 * \param parent the parent QObject.
+	 */
+	explicit VideoFrameFanout(QObject* parent = nullptr);
+
+	/*! \brief Add a surface to forward the frames to.
+	 *
+	 * The first surface added decides the supported pixel formats.
+	 *
+	 * \param surface the surface, must outlive the fanout or be removed.
+	 */
+	void addSurface(QAbstractVideoSurface* surface);
+
+	/*! \brief Stop forwarding the frames to a surface.
+	 *
+	 * \param surface the surface.
+	 */
+	void removeSurface(QAbstractVideoSurface* surface);
+
+	QList<QVideoFrame::PixelFormat> supportedPixelFormats(
+	  QAbstractVideoBuffer::HandleType type = QAbstractVideoBuffer::NoHandle) const override;
+
+	bool start(QVideoSurfaceFormat const& format) override;
+	void stop() override;
+	bool present(QVideoFrame const& frame) override;
+
+protected:
+	std::vector<QAbstractVideoSurface*> surfaces;
+};
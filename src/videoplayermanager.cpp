@@ -5,15 +5,29 @@
 #include <QMediaContent>
 
 #include <QKeyEvent>
+#include <QResizeEvent>
+
+#include <QPixmap>
+
+#include <QGuiApplication>
+#include <QScreen>
 
 #include <QMessageBox>
 
-#include <QDir>
+#include <QLoggingCategory>
+
+#include <QtConcurrent>
 
+#include <stdexcept>
+
+// std::min, std::max
+#include <algorithm>
+// INT_MAX
+#include <climits>
 // std::abs
 #include <cstdlib>
-// std::find_if
-#include <algorithm>
+
+Q_LOGGING_CATEGORY(seekLog, "slideo.seek")
 
 VideoPlayerManager::VideoPlayerManager(QWidget& parent, qint64 position, bool presentationMode)
       : QVideoWidget(&parent)
@@ -21,58 +35,193 @@ VideoPlayerManager::VideoPlayerManager(QWidget& parent, qint64 position, bool pr
       , player(&parent)
       , playlist(this)
       , presentationMode(presentationMode)
-      , initialPosition(position) {
+      , initialPosition(position)
+      , frameCache(this)
+      , frameOverlay(this) {
+#if QT_VERSION >= QT_VERSION_CHECK(5, 15, 0)
+	if(presentationMode) {
+		// So the presenter views can be added
+		videoFanout.addSurface(videoSurface());
+		player.setVideoOutput(&videoFanout);
+	} else {
+		player.setVideoOutput(this);
+	}
+#else
 	player.setVideoOutput(this);
+#endif
 	player.setPlaylist(&playlist);
-	player.setNotifyInterval(9);
+	// Only used for the UI, breakpoints are handled by breakpointTimer
+	player.setNotifyInterval(50);
+
+	breakpointTimer.setSingleShot(true);
+	breakpointTimer.setTimerType(Qt::PreciseTimer);
 
 	setFocusPolicy(Qt::ClickFocus);
 
+	frameOverlay.setAlignment(Qt::AlignCenter);
+	frameOverlay.setStyleSheet("background-color: black;");
+	frameOverlay.hide();
+
+	overlayTimer.setSingleShot(true);
+	overlayTimer.setTimerType(Qt::PreciseTimer);
+	connect(&overlayTimer, SIGNAL(timeout()), this, SLOT(showNextOverlayFrame()));
+
+	if(videoProbe.setSource(&player)) {
+		connect(&videoProbe, SIGNAL(videoFrameProbed(QVideoFrame const&)), this, SLOT(checkPresentedFrame(QVideoFrame const&)));
+	} else {
+		connect(this, SIGNAL(positionChanged(qint64)), this, SLOT(checkPresentedPosition(qint64)));
+	}
+
+	connect(&player, SIGNAL(positionChanged(qint64)), this, SLOT(updatePosition(qint64)));
+	connect(&player, SIGNAL(durationChanged(qint64)), this, SLOT(updateClipDuration(qint64)));
+	connect(this, SIGNAL(durationChanged(qint64)), this, SLOT(updateSeekDuration(qint64)));
+
 	connect(&player, SIGNAL(error(QMediaPlayer::Error)), this, SLOT(handleError()));
-	connect(&player, SIGNAL(durationChanged(qint64)), this, SLOT(updateSeekDuration(qint64)));
-	connect(&player, SIGNAL(positionChanged(qint64)), this, SLOT(pauseOnBreakpoint(qint64)));
-	connect(&playlist, SIGNAL(currentMediaChanged(QMediaContent const&)), this, SLOT(resetBreakpointsIterators()));
+	connect(&player, SIGNAL(stateChanged(QMediaPlayer::State)), this, SLOT(scheduleBreakpointPause()));
+	connect(&player, SIGNAL(mediaStatusChanged(QMediaPlayer::MediaStatus)), this, SLOT(scheduleBreakpointPause()));
+	connect(&player, SIGNAL(playbackRateChanged(qreal)), this, SLOT(scheduleBreakpointPause()));
+	connect(&breakpointTimer, SIGNAL(timeout()), this, SLOT(pauseOnBreakpoint()));
+	connect(&playlist, SIGNAL(currentIndexChanged(int)), this, SLOT(startClip(int)));
+	connect(&player, SIGNAL(mediaStatusChanged(QMediaPlayer::MediaStatus)), this, SLOT(applyClipPosition(QMediaPlayer::MediaStatus)));
+	connect(&keyframeIndexWatcher, SIGNAL(finished()), this, SLOT(storeKeyframeIndex()));
+
+	// In case the frame of the target is never presented (e.g. past the end)
+	seekTimeout.setSingleShot(true);
+	seekTimeout.setInterval(500);
+	connect(&seekTimeout, SIGNAL(timeout()), this, SLOT(settleSeek()));
 
 	if(presentationMode) {
+		// Shown by startPresentation, the video is loaded while hidden
 		this->setWindowFlags(Qt::Window);
-		this->setWindowState(Qt::WindowFullScreen);
-		parent.hide();
-		this->show();
+		frameCache.setFrameSize(QGuiApplication::primaryScreen()->size());
 	}
 }
 
+VideoPlayerManager::~VideoPlayerManager() {
+	player.setVideoOutput(static_cast<QAbstractVideoSurface*>(nullptr));
+}
+
 qint64 VideoPlayerManager::getPosition() const {
-	return player.position();
+	if(pendingClipPosition >= 0) {
+		// The player is still loading the clip
+		return clipOffset() + pendingClipPosition;
+	}
+	return clipOffset() + player.position();
 }
 
 qint64 VideoPlayerManager::getDuration() const {
-	return player.duration();
+	return timeline.getDuration();
 }
 
 QMediaPlayer const& VideoPlayerManager::getPlayer() const {
 	return player;
 }
 
-void VideoPlayerManager::activateVideo() {
-	playlist.clear();
+qreal VideoPlayerManager::getPlaybackRate() const {
+	// The playback rate is 1.0 by default, 0.0 being "unspecified"
+	return (player.playbackRate() > 0.0) ? player.playbackRate() : 1.0;
+}
 
-	MainWindow& parent = dynamic_cast<MainWindow&>(this->parent);
+Timeline const& VideoPlayerManager::getTimeline() const {
+	return timeline;
+}
+
+qint64 VideoPlayerManager::getBreakpointTolerance() const {
+	return breakpointTolerance;
+}
+
+KeyframeIndex const& VideoPlayerManager::getKeyframeIndex() const {
+	return keyframeIndex;
+}
+
+QImage VideoPlayerManager::getBreakpointFrame(qint64 breakpoint) {
+	std::vector<FrameCache::Frame> const* frames = frameCache.find(breakpoint);
+	return frames ? frames->front().image : QImage();
+}
+
+void VideoPlayerManager::removePresenterView(QVideoWidget& view) {
+#if QT_VERSION >= QT_VERSION_CHECK(5, 15, 0)
+	videoFanout.removeSurface(view.videoSurface());
+#else
+	Q_UNUSED(view);
+#endif
+}
 
-	std::string basePath = parent.getProject().getProjectFileLocation(),
-	            filePath = parent.getProject().getVideoFile();
+bool VideoPlayerManager::addPresenterView(QVideoWidget& view) {
+#if QT_VERSION >= QT_VERSION_CHECK(5, 15, 0)
+	if(presentationMode) {
+		videoFanout.addSurface(view.videoSurface());
+		return true;
+	}
+#else
+	Q_UNUSED(view);
+#endif
+	return false;
+}
 
-	QDir qBaseDirectory = QDir(QString::fromStdString(basePath));
-	QString qFilePath = qBaseDirectory.filePath(QString::fromStdString(filePath));
+void VideoPlayerManager::startPresentation(qint64 position, QScreen* screen) {
+	if(targetPosition() != position) {
+		pause();
+		setPosition(position);
+		showCachedFrames(position, /* playing = */ false);
+	}
+
+	if(screen) {
+		this->setGeometry(screen->geometry());
+	}
+
+	this->setWindowState(Qt::WindowFullScreen);
+	parent.hide();
+	this->show();
+	this->activateWindow();
+	this->setFocus();
+}
+
+void VideoPlayerManager::preparePresentation(qint64 position) {
+	if(!isVisible() && targetPosition() != position) {
+		setPosition(position);
+	}
+}
+
+void VideoPlayerManager::activateVideo() {
+	playlist.clear();
 
-	playlist.addMedia(QMediaContent(QUrl::fromLocalFile(qFilePath)));
+	ProjectManager const& project = dynamic_cast<MainWindow&>(parent).getProject();
+	timeline = project.getTimeline();
 
-	playlist.setCurrentIndex(0);
-	player.setPosition(initialPosition);
+	// The next clip is loaded by the player when the current one ends
+	for(std::size_t i = 0 ; i < timeline.size() ; ++i) {
+		playlist.addMedia(QMediaContent(QUrl::fromLocalFile(timeline.at(i).file)));
+	}
+	frameCache.setTimeline(timeline);
+	emit durationChanged(timeline.getDuration());
+
+	keyframeIndex = KeyframeIndex();
+	// The presentation player receives the index of the main one
+	if(!presentationMode) {
+		keyframeIndexWatcher.setFuture(QtConcurrent::run(
+		  [indexFile = QString::fromStdString(project.getKeyframeIndexFile()),
+		   timeline = this->timeline]() {
+			  try {
+				  return KeyframeIndex::loadOrBuild(indexFile, timeline);
+			  } catch(std::runtime_error const&) {
+				  // Seeks will not be planned
+				  return KeyframeIndex();
+			  }
+		  }));
+	}
+
+	pendingClipPosition = -1;
+	seekPlayer(initialPosition);
 	// Hack to show the first frame
 	player.play();
 	player.pause();
 }
 
+void VideoPlayerManager::setKeyframeIndex(KeyframeIndex const& keyframeIndex) {
+	this->keyframeIndex = keyframeIndex;
+}
+
 void VideoPlayerManager::updateSeekDuration(qint64 videoDuration) {
 	seekDuration = (videoDuration > 10'000)? 1'000 : videoDuration / 10;
 }
@@ -83,58 +232,399 @@ void VideoPlayerManager::handleError() {
 
 void VideoPlayerManager::playPause() {
 	if(player.state() == QMediaPlayer::PlayingState) {
-		player.pause();
+		pause();
 	} else {
-		player.play();
+		play();
 	}
 }
 
 void VideoPlayerManager::play() {
+	if(player.state() != QMediaPlayer::PlayingState && nextBreakpointIndex > 0) {
+		// Resuming from a breakpoint, hide the decoding delay of the player
+		BreakpointSet const& breakpoints = dynamic_cast<MainWindow&>(parent).getProject().getBreakpoints();
+		if(nextBreakpointIndex <= breakpoints.size()) {
+			qint64 breakpoint = breakpoints.at(nextBreakpointIndex - 1);
+			if(std::abs(getPosition() - breakpoint) <= breakpointTolerance) {
+				showCachedFrames(breakpoint, /* playing = */ true);
+			}
+		}
+	}
 	player.play();
 }
 
 void VideoPlayerManager::pause() {
+	hideFrameOverlay();
 	player.pause();
 }
 
+void VideoPlayerManager::setPlaybackRate(qreal rate) {
+	// The breakpoint timer is re-armed through playbackRateChanged
+	player.setPlaybackRate(std::min(std::max(rate, minPlaybackRate), maxPlaybackRate));
+}
+
 void VideoPlayerManager::setPosition(qint64 position) {
-	player.setPosition(position);
-	resetBreakpointsIterators();
+	hideFrameOverlay();
+	requestSeek(position);
 }
 
 void VideoPlayerManager::setPosition(int position) {
-	player.setPosition(position);
-	resetBreakpointsIterators();
+	hideFrameOverlay();
+	if(keyframeIndex.seekCost(position) > maxScrubSeekCost) {
+		requestSeek(keyframeIndex.nearestKeyframe(position));
+	} else {
+		requestSeek(position);
+	}
+}
+
+void VideoPlayerManager::finishScrubbing(int position) {
+	if(targetPosition() != position) {
+		hideFrameOverlay();
+		requestSeek(position);
+	}
 }
 
 void VideoPlayerManager::seekForward() {
-	player.setPosition(player.position() + seekDuration);
-	resetBreakpointsIterators();
+	hideFrameOverlay();
+	requestSeek(targetPosition() + seekDuration);
 }
 
 void VideoPlayerManager::seekBackward() {
-	player.setPosition(player.position() - seekDuration);
-	resetBreakpointsIterators();
+	hideFrameOverlay();
+	requestSeek(std::max<qint64>(targetPosition() - seekDuration, 0));
 }
 
-void VideoPlayerManager::pauseOnBreakpoint(qint64 const& position) {
-	if(player.state() == QMediaPlayer::PlayingState && position) {
-		if(nextBreakpointIt == breakpointsEndIt) {
-			return;
-		} else if(std::abs(position - *nextBreakpointIt) <= 10) {
-			player.pause();
-			++nextBreakpointIt;
-			return;
-		}
+void VideoPlayerManager::jumpToNextBreakpoint() {
+	BreakpointSet const& breakpoints = dynamic_cast<MainWindow&>(parent).getProject().getBreakpoints();
+	std::size_t index = breakpoints.upperBound(targetPosition() + breakpointTolerance, nextBreakpointIndex);
+	if(index < breakpoints.size()) {
+		jumpToBreakpoint(breakpoints.at(index));
+	}
+}
+
+void VideoPlayerManager::jumpToPreviousBreakpoint() {
+	BreakpointSet const& breakpoints = dynamic_cast<MainWindow&>(parent).getProject().getBreakpoints();
+	std::size_t index = breakpoints.lowerBound(targetPosition() - breakpointTolerance);
+	jumpToBreakpoint((index > 0) ? breakpoints.at(index - 1) : 0);
+}
+
+void VideoPlayerManager::pauseOnBreakpoint() {
+	BreakpointSet const& breakpoints = dynamic_cast<MainWindow&>(parent).getProject().getBreakpoints();
+	if(player.state() != QMediaPlayer::PlayingState || nextBreakpointIndex >= breakpoints.size()) {
+		return;
+	}
+
+	qint64 breakpoint = breakpoints.at(nextBreakpointIndex);
+	if(breakpoint - getPosition() > breakpointTolerance) {
+		// The timer fired too early (e.g. the pipeline was late), try again
+		scheduleBreakpointPause();
+		return;
+	}
+
+	player.pause();
+	++nextBreakpointIndex;
+
+	// Land on the breakpoint's frame even if we overshot it
+	if(getPosition() != breakpoint) {
+		seekPlayer(breakpoint);
 	}
+
+	prefetchFrames();
+}
+
+void VideoPlayerManager::scheduleBreakpointPause() {
+	breakpointTimer.stop();
+
+	BreakpointSet const& breakpoints = dynamic_cast<MainWindow&>(parent).getProject().getBreakpoints();
+	if(player.state() != QMediaPlayer::PlayingState || nextBreakpointIndex >= breakpoints.size()) {
+		return;
+	}
+
+	// The breakpoints iterators are only valid again once the seek settled
+	if(seekInFlight) {
+		return;
+	}
+
+	// Will be re-armed when the media status changes again
+	QMediaPlayer::MediaStatus status = player.mediaStatus();
+	if(status == QMediaPlayer::StalledMedia || status == QMediaPlayer::LoadingMedia) {
+		return;
+	}
+
+	// The remaining media time, converted to wall time
+	qint64 remaining = std::max<qint64>(breakpoints.at(nextBreakpointIndex) - getPosition(), 0);
+	qint64 delay = qRound64(remaining / getPlaybackRate());
+	if(delay > 2 * breakpointLead) {
+		// Wake up early, the last stretch is scheduled again from a fresh position
+		delay -= breakpointLead;
+	}
+
+	breakpointTimer.start(static_cast<int>(std::min<qint64>(delay, INT_MAX)));
 }
 
 void VideoPlayerManager::resetBreakpointsIterators() {
 	MainWindow& parent = dynamic_cast<MainWindow&>(this->parent);
-	nextBreakpointIt = std::find_if(parent.getProject().getBreakpoints().cbegin(),
-	                                parent.getProject().getBreakpoints().cend(),
-	                                [this](qint64 value) { return value > player.position(); });
-	breakpointsEndIt = parent.getProject().getBreakpoints().cend();
+	// Consecutive seeks are usually close to each other, so start from the last result
+	nextBreakpointIndex =
+	  parent.getProject().getBreakpoints().upperBound(getPosition(), nextBreakpointIndex);
+	scheduleBreakpointPause();
+	prefetchFrames();
+}
+
+void VideoPlayerManager::prefetchFrames() {
+	BreakpointSet const& breakpoints = dynamic_cast<MainWindow&>(parent).getProject().getBreakpoints();
+	std::size_t size = breakpoints.size();
+
+	// Most urgent first: the breakpoint we may resume from, the next ones, then
+	// the previous one for jumping back
+	std::vector<qint64> wanted;
+	if(nextBreakpointIndex > 0 && nextBreakpointIndex <= size) {
+		wanted.push_back(breakpoints.at(nextBreakpointIndex - 1));
+	}
+	for(std::size_t i = nextBreakpointIndex ; i < std::min(nextBreakpointIndex + 3, size) ; ++i) {
+		wanted.push_back(breakpoints.at(i));
+	}
+	if(nextBreakpointIndex > 1 && nextBreakpointIndex <= size + 1) {
+		wanted.push_back(breakpoints.at(nextBreakpointIndex - 2));
+	}
+	if(presentationMode) {
+		// Shown right away if the presentation starts from the beginning
+		wanted.push_back(0);
+	}
+	if(playlist.currentIndex() + 1 < static_cast<int>(timeline.size())) {
+		// Shown while the player loads the next clip, see startClip
+		wanted.push_back(timeline.at(playlist.currentIndex() + 1).offset);
+	}
+
+	frameCache.prefetch(wanted);
+}
+
+void VideoPlayerManager::showNextOverlayFrame() {
+	if(overlayIndex + 1 >= overlayFrames.size()) {
+		// Keep the last frame until the player catches up
+		return;
+	}
+
+	++overlayIndex;
+	setOverlayFrame(overlayFrames[overlayIndex].image);
+
+	if(overlayIndex + 1 < overlayFrames.size()) {
+		qreal rate = getPlaybackRate();
+		qint64 delay = overlayFrames[overlayIndex + 1].position - overlayFrames[overlayIndex].position;
+		overlayTimer.start(static_cast<int>(qRound64(delay / rate)));
+	}
+}
+
+void VideoPlayerManager::checkPresentedFrame(QVideoFrame const& frame) {
+	if(frame.startTime() < 0) {
+		checkPresentedPosition(getPosition());
+	} else {
+		checkPresentedPosition(clipOffset() + frame.startTime() / 1'000);
+	}
+}
+
+void VideoPlayerManager::checkPresentedPosition(qint64 position) {
+	if(seekInFlight && std::abs(position - inFlightSeek) <= seekSettleTolerance) {
+		settleSeek();
+	}
+
+	if(!frameOverlay.isVisible() || overlayFrames.empty()) {
+		return;
+	}
+
+	if(position >= overlayFrames[overlayIndex].position - breakpointTolerance) {
+		hideFrameOverlay();
+	}
+}
+
+void VideoPlayerManager::settleSeek() {
+	if(!seekInFlight) {
+		return;
+	}
+
+	seekInFlight = false;
+	seekTimeout.stop();
+
+	if(pendingSeek >= 0) {
+		// Only the latest target matters, the superseded ones were dropped
+		qint64 target = pendingSeek;
+		pendingSeek = -1;
+		startSeek(target);
+		return;
+	}
+
+	lastSeekLatency = seekLatency.elapsed();
+	qCDebug(seekLog) << "Seek to" << inFlightSeek << "settled in" << lastSeekLatency << "ms";
+	emit seekSettled(lastSeekLatency);
+
+	// Once per burst of seeks, now that the player is at the target
+	resetBreakpointsIterators();
+}
+
+void VideoPlayerManager::hideFrameOverlay() {
+	overlayTimer.stop();
+	frameOverlay.hide();
+	frameOverlay.clear();
+	overlayFrames.clear();
+	overlayIndex = 0;
+}
+
+void VideoPlayerManager::storeKeyframeIndex() {
+	keyframeIndex = keyframeIndexWatcher.result();
+	emit keyframeIndexLoaded(keyframeIndex);
+}
+
+void VideoPlayerManager::updatePosition(qint64 clipPosition) {
+	// Still the position in the previous clip
+	if(pendingClipPosition < 0) {
+		emit positionChanged(clipOffset() + clipPosition);
+	}
+}
+
+void VideoPlayerManager::updateClipDuration(qint64 clipDuration) {
+	int index = playlist.currentIndex();
+	if(index >= 0 && index < static_cast<int>(timeline.size()) &&
+	   timeline.at(index).duration <= 0 && clipDuration > 0) {
+		timeline.setDuration(index, clipDuration);
+		emit durationChanged(timeline.getDuration());
+	}
+}
+
+void VideoPlayerManager::startClip(int index) {
+	if(index < 0 || index >= static_cast<int>(timeline.size())) {
+		return;
+	}
+
+	if(pendingClipPosition >= 0) {
+		// Reached by seeking, the position is the one pending
+		resetBreakpointsIterators();
+		return;
+	}
+
+	// Reached by playing: the player might still report the end of the
+	// previous clip, and the breakpoints at the start of this one must not be
+	// skipped
+	qint64 offset = timeline.at(index).offset;
+	nextBreakpointIndex =
+	  dynamic_cast<MainWindow&>(parent).getProject().getBreakpoints().lowerBound(offset);
+	// Re-armed from a fresh position once the clip is loaded, see
+	// scheduleBreakpointPause
+	breakpointTimer.stop();
+	prefetchFrames();
+
+	if(player.state() == QMediaPlayer::PlayingState) {
+		showCachedFrames(offset, /* playing = */ true);
+	}
+}
+
+void VideoPlayerManager::applyClipPosition(QMediaPlayer::MediaStatus status) {
+	if(pendingClipPosition >= 0 &&
+	   (status == QMediaPlayer::LoadedMedia || status == QMediaPlayer::BufferedMedia)) {
+		player.setPosition(pendingClipPosition);
+		pendingClipPosition = -1;
+	}
+}
+
+void VideoPlayerManager::requestSeek(qint64 position) {
+	// Measured from the latest input
+	seekLatency.start();
+
+	if(seekInFlight) {
+		pendingSeek = position;
+	} else {
+		startSeek(position);
+	}
+}
+
+void VideoPlayerManager::startSeek(qint64 position) {
+	// Armed for the breakpoints around the previous position, re-armed by
+	// settleSeek
+	breakpointTimer.stop();
+	seekInFlight = true;
+	inFlightSeek = position;
+	seekPlayer(position);
+	seekTimeout.start();
+}
+
+void VideoPlayerManager::seekPlayer(qint64 position) {
+	if(timeline.empty()) {
+		player.setPosition(position);
+		return;
+	}
+
+	std::size_t clip = timeline.clipAt(position);
+	qint64 clipPosition = position - timeline.at(clip).offset;
+	if(static_cast<int>(clip) != playlist.currentIndex()) {
+		// Applied once the clip is loaded
+		pendingClipPosition = clipPosition;
+		playlist.setCurrentIndex(static_cast<int>(clip));
+	} else if(pendingClipPosition >= 0) {
+		// The clip is still loading
+		pendingClipPosition = clipPosition;
+	} else {
+		player.setPosition(clipPosition);
+	}
+}
+
+qint64 VideoPlayerManager::clipOffset() const {
+	int index = playlist.currentIndex();
+	if(index < 0 || index >= static_cast<int>(timeline.size())) {
+		return 0;
+	}
+	return timeline.at(index).offset;
+}
+
+qint64 VideoPlayerManager::targetPosition() const {
+	if(pendingSeek >= 0) {
+		return pendingSeek;
+	} else if(seekInFlight) {
+		return inFlightSeek;
+	}
+	return getPosition();
+}
+
+qint64 VideoPlayerManager::getLastSeekLatency() const {
+	return lastSeekLatency;
+}
+
+void VideoPlayerManager::setOverlayFrame(QImage const& frame) {
+	QPixmap pixmap = QPixmap::fromImage(frame);
+	if(pixmap.size() != size()) {
+		// Decoded for another size of the widget
+		pixmap = pixmap.scaled(size(), Qt::KeepAspectRatio, Qt::SmoothTransformation);
+	}
+	frameOverlay.setPixmap(pixmap);
+}
+
+void VideoPlayerManager::jumpToBreakpoint(qint64 breakpoint) {
+	player.pause();
+	setPosition(breakpoint);
+	// The player is fast enough when the breakpoint is a keyframe
+	if(keyframeIndex.seekCost(breakpoint) > 0) {
+		showCachedFrames(breakpoint, /* playing = */ false);
+	}
+}
+
+bool VideoPlayerManager::showCachedFrames(qint64 breakpoint, bool playing) {
+	std::vector<FrameCache::Frame> const* frames = frameCache.find(breakpoint);
+	if(!frames) {
+		return false;
+	}
+
+	overlayTimer.stop();
+	overlayFrames = *frames;
+	overlayIndex = 0;
+
+	setOverlayFrame(overlayFrames.front().image);
+	frameOverlay.setGeometry(rect());
+	frameOverlay.raise();
+	frameOverlay.show();
+
+	if(playing && overlayFrames.size() > 1) {
+		qreal rate = getPlaybackRate();
+		qint64 delay = overlayFrames[1].position - overlayFrames[0].position;
+		overlayTimer.start(static_cast<int>(qRound64(delay / rate)));
+	}
+	return true;
 }
 
 void VideoPlayerManager::keyPressEvent(QKeyEvent* event) {
@@ -143,6 +633,10 @@ void VideoPlayerManager::keyPressEvent(QKeyEvent* event) {
 			playPause();
 		} else if(event->key() == Qt::Key_Escape) {
 			this->close();
+		} else if(event->key() == Qt::Key_Right || event->key() == Qt::Key_PageDown) {
+			jumpToNextBreakpoint();
+		} else if(event->key() == Qt::Key_Left || event->key() == Qt::Key_PageUp) {
+			jumpToPreviousBreakpoint();
 		} else {
 			QVideoWidget::keyPressEvent(event);
 		}
@@ -166,7 +660,19 @@ void VideoPlayerManager::keyPressEvent(QKeyEvent* event) {
 
 void VideoPlayerManager::closeEvent(QCloseEvent* event) {
 	if(presentationMode) {
+		// Only hidden, so it stays ready for the next presentation
+		pause();
 		this->parentWidget()->show();
+		emit presentationFinished();
 	}
 	QVideoWidget::closeEvent(event);
 }
+
+void VideoPlayerManager::resizeEvent(QResizeEvent* event) {
+	frameOverlay.setGeometry(QRect(QPoint(0, 0), event->size()));
+	if(!overlayFrames.empty()) {
+		setOverlayFrame(overlayFrames[overlayIndex].image);
+	}
+	frameCache.setFrameSize(event->size());
+	QVideoWidget::resizeEvent(event);
+}
@@ -1,15 +1,32 @@
 #pragma once
 
+#include "framecache.hpp"
+#include "keyframeindex.hpp"
+#include "timeline.hpp"
+#include "videoframefanout.hpp"
+
 #include <QVideoWidget>
 
 #include <QMediaPlayer>
 #include <QMediaPlaylist>
+#include <QVideoFrame>
+#include <QVideoProbe>
+
+#include <QFutureWatcher>
+
+#include <QElapsedTimer>
+#include <QLabel>
+#include <QScreen>
+#include <QTimer>
 
-#include <set>
+#include <vector>
 
 /*! \brief Class used to handle the video player
  *
  * It handle both the view and the model as the video management is pretty simple.
+ *
+ * The clips of the project are played one after the other from a playlist.
+ * Positions are on the timeline of the project, see Timeline.
  */
 class VideoPlayerManager : public QVideoWidget {
 
@@ -18,21 +35,28 @@ class VideoPlayerManager : public QVideoWidget {
 public:
 	/*! \brief VideoPlayerManager constructor
 	 *
-	 * It will create the widget, the player and the playlist
+	 * It will create the widget, the player and the playlist. In presentation
+	 * mode, the widget is a hidden window until startPresentation is called.
 	 *
 	 * \param parent the parent widget (the main window)
 	 * \param position the initial position in the video (in msecs)
-	 * \param presentationMode true if the VideoPlayerManager must be started in
-	 *        a presentation mode.
+	 * \param presentationMode true if the VideoPlayerManager is used for
+	 *        presentations.
 	 */
 	explicit VideoPlayerManager(QWidget& parent, qint64 position = 0,
 	                            bool presentationMode = false);
 
-	/*! \brief Return the current position in the video.
+	/*! \brief VideoPlayerManager destructor.
+	 *
+	 * Detaches the player from the frame fanout, which is destroyed first.
+	 */
+	~VideoPlayerManager();
+
+	/*! \brief Return the current position on the timeline.
 	 */
 	qint64 getPosition() const;
 
-	/*! \brief Return the length of the current video.
+	/*! \brief Return the length of the timeline.
 	 */
 	qint64 getDuration() const;
 
@@ -42,16 +66,143 @@ public:
 	 */
 	QMediaPlayer const& getPlayer() const;
 
+	/*! \brief Get the playback rate, 1.0 being the normal speed.
+	 */
+	qreal getPlaybackRate() const;
+
+	/*! \brief Get the timeline being played.
+	 *
+	 * The durations unknown to the project are completed as the player loads
+	 * the clips.
+	 *
+	 * \return the timeline.
+	 */
+	Timeline const& getTimeline() const;
+
+	/*! \brief Get the distance under which a position is considered on a
+	 * breakpoint.
+	 *
+	 * \return the tolerance in msecs.
+	 */
+	qint64 getBreakpointTolerance() const;
+
+	/*! \brief Get the keyframe index of the timeline.
+	 *
+	 * The index is empty until it is loaded or built in the background.
+	 *
+	 * \return the keyframe index.
+	 */
+	KeyframeIndex const& getKeyframeIndex() const;
+
+	/*! \brief Get the duration of the last burst of seeks.
+	 *
+	 * Measured from the last user input of the burst to the presentation of
+	 * the frame at the target position.
+	 *
+	 * \return the latency in msecs, -1 if there was no seek yet.
+	 */
+	qint64 getLastSeekLatency() const;
+
+	/*! \brief Get the first frame of a breakpoint if it was decoded ahead.
+	 *
+	 * \param breakpoint the breakpoint in msecs.
+	 * \return the frame, or a null image if it is not decoded yet.
+	 */
+	QImage getBreakpointFrame(qint64 breakpoint);
+
+	/*! \brief Show the video in another widget too.
+	 *
+	 * Only in presentation mode. The frames are decoded once and shared by
+	 * both widgets. Requires Qt 5.15.
+	 *
+	 * \param view the other widget.
+	 * \return false if not supported.
+	 */
+	bool addPresenterView(QVideoWidget& view);
+
+	/*! \brief Stop showing the video in a widget added by addPresenterView.
+	 *
+	 * Must be called before the widget is destroyed.
+	 *
+	 * \param view the other widget.
+	 */
+	void removePresenterView(QVideoWidget& view);
+
+signals:
+	/*! \brief Emitted when the presentation is left.
+	 */
+	void presentationFinished();
+
+	/*! \brief Emitted when the position on the timeline changed.
+	 *
+	 * Like QMediaPlayer::positionChanged, for the whole timeline.
+	 *
+	 * \param position the position in msecs.
+	 */
+	void positionChanged(qint64 position);
+
+	/*! \brief Emitted when the duration of the timeline changed.
+	 *
+	 * \param duration the duration in msecs.
+	 */
+	void durationChanged(qint64 duration);
+
+	/*! \brief Emitted when the player reached the target of the last seek.
+	 *
+	 * Also logged in the "slideo.seek" category.
+	 *
+	 * \param latency see getLastSeekLatency.
+	 */
+	void seekSettled(qint64 latency);
+
+	/*! \brief Emitted when the keyframe index was loaded or built in the
+	 * background.
+	 *
+	 * \param keyframeIndex the keyframe index.
+	 */
+	void keyframeIndexLoaded(KeyframeIndex const& keyframeIndex);
+
 public slots:
+	/*! \brief Show the presentation in fullscreen.
+	 *
+	 * Only in presentation mode. The video must be activated beforehand, so
+	 * the media is already loaded.
+	 *
+	 * \param position the position to start from, in msecs.
+	 * \param screen the screen to show the presentation on, nullptr for the
+	 *        current one.
+	 */
+	void startPresentation(qint64 position, QScreen* screen = nullptr);
+
+	/*! \brief Seek to the position the next presentation will likely start
+	 * from.
+	 *
+	 * Only in presentation mode, ignored while presenting.
+	 *
+	 * \param position the position in msecs.
+	 */
+	void preparePresentation(qint64 position);
+
 	/*! \brief Activate the video.
 	 *
-	 * Loads the video from the current projet. Called when a project is loaded.
+	 * Loads the clips from the current projet. Called when a project is
+	 * loaded or its clips changed. Outside of presentation mode, also loads
+	 * or builds the keyframe index in the background.
 	 */
 	void activateVideo();
 
+	/*! \brief Set the keyframe index of the timeline.
+	 *
+	 * Only in presentation mode: the index is built once by the main player,
+	 * see keyframeIndexLoaded.
+	 *
+	 * \param keyframeIndex the keyframe index.
+	 */
+	void setKeyframeIndex(KeyframeIndex const& keyframeIndex);
+
 	/*! \brief Update the seek forward/backward duration.
 	 *
-	 * \param videoDuration duration of the current video.
+	 * \param videoDuration duration of the timeline.
 	 */
 	void updateSeekDuration(qint64 videoDuration);
 
@@ -71,6 +222,16 @@ public slots:
 	 */
 	void pause();
 
+	/*! \brief Set the playback rate.
+	 *
+	 * The breakpoints are still paused on at the right position, whatever the
+	 * rate.
+	 *
+	 * \param rate the rate, 1.0 being the normal speed. Clamped between
+	 *        minPlaybackRate and maxPlaybackRate.
+	 */
+	void setPlaybackRate(qreal rate);
+
 	/*! \brief Set the position in the video.
 	 *
 	 * The position must be in msecs.
@@ -83,12 +244,22 @@ public slots:
 	/*! \brief Set the position in the video.
 	 *
 	 * The position must be in msecs.
-	 * Used when the seek bar is moved by the user.
+	 * Used when the seek bar is moved by the user without preview: if seeking
+	 * to the exact position is expensive, the player seeks to the nearest
+	 * keyframe instead, until finishScrubbing is called.
 	 *
 	 * \param position the position to set.
 	 */
 	void setPosition(int position);
 
+	/*! \brief Seek to the exact position selected with the seek bar.
+	 *
+	 * Used when the seek bar is released by the user.
+	 *
+	 * \param position the position in msecs.
+	 */
+	void finishScrubbing(int position);
+
 	/*! \brief Seek forward in the video.
 	 *
 	 * Uses the seekDuration property.
@@ -101,28 +272,173 @@ public slots:
 	 */
 	void seekBackward();
 
+	/*! \brief Jump to the next breakpoint and pause.
+	 */
+	void jumpToNextBreakpoint();
+
+	/*! \brief Jump to the previous breakpoint and pause.
+	 *
+	 * Jumps to the beginning of the video if there is no previous breakpoint.
+	 */
+	void jumpToPreviousBreakpoint();
+
 protected slots:
 	/*! \brief Pause if the current position is a breakpoint.
 	 *
-	 * Called if the position in the video has changed.
+	 * Called when the breakpoint timer times out. If the player is not close
+	 * enough to the breakpoint yet (the timer is only an estimation), the timer
+	 * is re-armed instead.
+	 */
+	void pauseOnBreakpoint();
+
+	/*! \brief Arm the breakpoint timer for the next breakpoint.
 	 *
-	 * \param position the position in the video.
+	 * Computes the time remaining until the next breakpoint and arms a single
+	 * shot timer. Called on seek, play/pause, playback rate change and media
+	 * status change (e.g. when the media stalls). Not armed while a seek is
+	 * in flight, see settleSeek.
 	 */
-	void pauseOnBreakpoint(qint64 const& position);
+	void scheduleBreakpointPause();
 
-	/*! \brief Reset the breakpoints iterators
-	 * (nextBreakpointIt and breakpointsEndIt).
+	/*! \brief Reset the breakpoints iterator (nextBreakpointIndex).
 	 *
-	 * Called when the media changed.
+	 * Called when a seek settled or the project's breakpoints changed. This
+	 * will also re-arm the breakpoint timer.
 	 */
 	void resetBreakpointsIterators();
 
+	/*! \brief Decode the frames around the next breakpoint, and at the
+	 * beginning of the next clip, in the background.
+	 */
+	void prefetchFrames();
+
+	/*! \brief Show the next cached frame in the frame overlay.
+	 *
+	 * Called by the overlay timer while resuming from a breakpoint.
+	 */
+	void showNextOverlayFrame();
+
+	/*! \brief Hide the frame overlay once the player caught up with it.
+	 *
+	 * \param frame a frame presented by the player.
+	 */
+	void checkPresentedFrame(QVideoFrame const& frame);
+
+	/*! \brief Hide the frame overlay once the player caught up with it, and
+	 * settle the seek in flight once its target is presented.
+	 *
+	 * Used instead of checkPresentedFrame if the media backend does not
+	 * support probing.
+	 *
+	 * \param position the current position of the player.
+	 */
+	void checkPresentedPosition(qint64 position);
+
+	/*! \brief Hide the frame overlay and stop its timer.
+	 */
+	void hideFrameOverlay();
+
+	/*! \brief Store the keyframe index built in the background.
+	 */
+	void storeKeyframeIndex();
+
+	/*! \brief Emit positionChanged from a position in the current clip.
+	 *
+	 * \param clipPosition the position of the player in the current clip.
+	 */
+	void updatePosition(qint64 clipPosition);
+
+	/*! \brief Complete the timeline with the duration of the current clip, if
+	 * it was unknown, and emit durationChanged.
+	 *
+	 * \param clipDuration the duration of the current clip.
+	 */
+	void updateClipDuration(qint64 clipDuration);
+
+	/*! \brief Follow the clip reached while playing or seeking.
+	 *
+	 * Resets the breakpoints iterator. If the clip was reached while playing,
+	 * shows the frames decoded ahead from the beginning of the clip while the
+	 * player loads it.
+	 *
+	 * \param index the index of the clip in the playlist.
+	 */
+	void startClip(int index);
+
+	/*! \brief Seek in a clip once it is loaded.
+	 *
+	 * \param status the status of the clip being loaded.
+	 */
+	void applyClipPosition(QMediaPlayer::MediaStatus status);
+
+	/*! \brief Handle the end of the seek in flight.
+	 *
+	 * Starts the latest pending seek if any. Otherwise, the breakpoints
+	 * iterator is reset, now that the player is at the target.
+	 */
+	void settleSeek();
+
 protected:
+	/*! \brief Seek the player, coalescing the seeks.
+	 *
+	 * At most one seek is in flight: while it is, only the latest requested
+	 * position is kept, and sought once the seek in flight settles.
+	 *
+	 * \param position the position in msecs.
+	 */
+	void requestSeek(qint64 position);
+
+	/*! \brief Start a seek of the player.
+	 *
+	 * \param position the position in msecs.
+	 */
+	void startSeek(qint64 position);
+
+	/*! \brief Set the position of the player, changing the clip if needed.
+	 *
+	 * \param position the position on the timeline in msecs.
+	 */
+	void seekPlayer(qint64 position);
+
+	/*! \brief Get the position of the beginning of the current clip on the
+	 * timeline.
+	 */
+	qint64 clipOffset() const;
+
+	/*! \brief Get the position the player is or will be at.
+	 *
+	 * Takes the seek in flight and the pending one into account.
+	 */
+	qint64 targetPosition() const;
+
+	/*! \brief Show a frame in the frame overlay, scaled to the widget.
+	 *
+	 * \param frame the frame.
+	 */
+	void setOverlayFrame(QImage const& frame);
+
+	/*! \brief Jump to a breakpoint and pause.
+	 *
+	 * \param breakpoint the breakpoint in msecs.
+	 */
+	void jumpToBreakpoint(qint64 breakpoint);
+
+	/*! \brief Show the cached frames of a breakpoint over the video.
+	 *
+	 * \param breakpoint the breakpoint in msecs.
+	 * \param playing true if the frames must be played, false to only show
+	 *        the first one.
+	 * \return false if the frames are not in the cache.
+	 */
+	bool showCachedFrames(qint64 breakpoint, bool playing);
+
 	/*! \brief Function called when the user presses a key.
 	 *
 	 * These key events are processed:
 	 *   - Space : Play/Pause
 	 *   - Escape (only in presentation mode) : Leave presentation mode
+	 *   - Right/Page Down (only in presentation mode) : next breakpoint
+	 *   - Left/Page Up (only in presentation mode) : previous breakpoint
 	 *   - Up (not in presentation mode) : seek forward
 	 *   - Down (not in presentation mode) : seek backward
 	 *
@@ -132,23 +448,92 @@ protected:
 
 	/*! \brief Function called when the user closes the window
 	 *
-	 * This function is useless unless the player is in presentation mode.
+	 * This function is useless unless the player is in presentation mode, in
+	 * which case the presentation is paused and the main window shown again.
 	 *
 	 * \param event the close event.
 	 */
 	virtual void closeEvent(QCloseEvent* event) override;
 
+	/*! \brief Function called when the widget is resized.
+	 *
+	 * Resizes the frame overlay and the frames decoded afterwards.
+	 *
+	 * \param event the resize event.
+	 */
+	virtual void resizeEvent(QResizeEvent* event) override;
+
 	QWidget& parent;
 
 	QMediaPlayer player;
 	QMediaPlaylist playlist;
+	Timeline timeline;
+	// Position in the clip being loaded, -1 if none
+	qint64 pendingClipPosition = -1;
 
 	bool presentationMode;
 	qint64 initialPosition;
 	qint64 seekDuration = 1;
 
-	std::set<qint64>::const_iterator nextBreakpointIt;
-	std::set<qint64>::const_iterator breakpointsEndIt;
+	/*! \brief Tolerance (in msecs of media time) under which the player is
+	 * considered to be on a breakpoint.
+	 */
+	qint64 breakpointTolerance = 10;
+	/*! \brief Time (in msecs of wall time) the breakpoint timer fires before
+	 * the estimated time of the breakpoint.
+	 *
+	 * A late timer makes the player overshoot the breakpoint by the delay
+	 * times the playback rate, so the timer is re-armed once close to it.
+	 */
+	qint64 breakpointLead = 20;
+	QTimer breakpointTimer;
+
+	qreal minPlaybackRate = 0.25;
+	qreal maxPlaybackRate = 4.0;
+
+	/*! \brief Index of the next breakpoint in the project's breakpoints.
+	 *
+	 * An index is kept instead of an iterator as the breakpoints are stored in a
+	 * vector. It is also used as a hint when looking for the next breakpoint
+	 * after a seek.
+	 */
+	std::size_t nextBreakpointIndex = 0;
+
+	/*! \brief Frames decoded in advance around the next breakpoints.
+	 */
+	FrameCache frameCache;
+
+	/*! \brief Shows cached frames over the video while the player is seeking.
+	 */
+	QLabel frameOverlay;
+	QTimer overlayTimer;
+	QVideoProbe videoProbe;
+	std::vector<FrameCache::Frame> overlayFrames;
+	std::size_t overlayIndex = 0;
+
+	bool seekInFlight = false;
+	qint64 inFlightSeek = 0;
+	qint64 pendingSeek = -1;
+	/*! \brief Distance (in msecs) from the target under which a presented
+	 * frame ends the seek in flight.
+	 */
+	qint64 seekSettleTolerance = 100;
+	QTimer seekTimeout;
+	QElapsedTimer seekLatency;
+	qint64 lastSeekLatency = -1;
+
+	/*! \brief Forwards the frames to the presenter views.
+	 *
+	 * Only used in presentation mode.
+	 */
+	VideoFrameFanout videoFanout;
+
+	KeyframeIndex keyframeIndex;
+	QFutureWatcher<KeyframeIndex> keyframeIndexWatcher;
+
+	/*! \brief Maximum number of frames decoded for a seek while scrubbing.
+	 */
+	qint64 maxScrubSeekCost = 12;
 
 private:
 };